@@ -9,8 +9,11 @@
 
 #include "include/core/SkPath.h"
 #include "include/core/SkRefCnt.h"
+#include "include/private/SkOnce.h"
 #include "include/private/SkTDArray.h"
 
+#include <atomic>
+
 namespace pk {
 struct SkConic;
 
@@ -26,6 +29,36 @@ public:
     bool PK_WARN_UNUSED_RESULT getPosTan(SkScalar distance, SkPoint* position,
                                          SkVector* tangent) const;
 
+    /** Computes the position and tangent at each of count distances, like calling getPosTan()
+     *  for each of them. Sorted distances are fastest: the segment search walks forward from
+     *  the previous sample, and samples that land on the same curve are evaluated four at a time.
+     *  Either pos or tan may be null. Samples whose distance is NaN, or whose position can't be
+     *  computed, are left untouched. Returns true if every sample was computed.
+     */
+    bool PK_WARN_UNUSED_RESULT getPosTan(const SkScalar distances[], int count, SkPoint pos[],
+                                         SkVector tan[]) const;
+
+    /** Finds the point on the contour nearest to point, searching only within maxDistance of it.
+     *  Sets closest to that point, distance to how far along the contour it lies (so that
+     *  getPosTan(distance) returns it), and tangent to the contour's direction there; any of
+     *  them may be null. Returns false if the contour has nothing within maxDistance.
+     *  The first query builds a bounding-box tree over the contour's curves, so a small
+     *  maxDistance, as for hit testing, only visits the curves nearby.
+     */
+    bool PK_WARN_UNUSED_RESULT getClosestPoint(const SkPoint& point, SkPoint* closest,
+                                               SkScalar* distance, SkVector* tangent,
+                                               SkScalar maxDistance = PK_ScalarInfinity) const;
+
+    /** Calls getClosestPoint() for each of count points. Points near each other, such as the
+     *  samples of a stroke being snapped, are fastest: each search starts from the curve the
+     *  previous one found. closest, distances and tangents may each be null. Points with nothing
+     *  within maxDistance are left untouched. Returns true if all of them were found.
+     */
+    bool PK_WARN_UNUSED_RESULT getClosestPoints(const SkPoint points[], int count,
+                                                SkPoint closest[], SkScalar distances[],
+                                                SkVector tangents[],
+                                                SkScalar maxDistance = PK_ScalarInfinity) const;
+
     enum MatrixFlags {
         kGetPosition_MatrixFlag     = 0x01,
         kGetTangent_MatrixFlag      = 0x02,
@@ -49,10 +82,26 @@ public:
     bool PK_WARN_UNUSED_RESULT getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
                                           bool startWithMoveTo) const;
 
+    /** Appends to dst the pieces between count pairs of distances, startStops[2 * i] to
+     startStops[2 * i + 1], each beginning with a moveTo. The result is the same as calling
+     getSegment(start, stop, dst, true) for each pair in turn, but when the pairs are sorted by
+     distance (as for dashes or trim ranges) the segments are walked once and dst is grown ahead
+     of time. Pairs that getSegment() would reject are skipped, and then false is returned.
+     */
+    bool PK_WARN_UNUSED_RESULT getSegments(const SkScalar startStops[], int count,
+                                           SkPath* dst) const;
+
     /** Return true if the contour is closed()
      */
     bool isClosed() const { return fIsClosed; }
 
+    /** Returns roughly how many bytes this measure keeps alive: the object, its segment table and
+     *  points, and whatever queries have built lazily so far (chords, the closest-point tree).
+     *  Points shared with the source path (see SkContourMeasureIter::kCompact_Storage) belong
+     *  to the path and are not counted.
+     */
+    size_t approximateBytesUsed() const;
+
 private:
     struct Segment {
         SkScalar    fDistance;  // total distance up to this point
@@ -62,52 +111,123 @@ private:
         // See SkPathMeasurePriv.h
 
         SkScalar getScalarT() const;
-
-        static const Segment* Next(const Segment* seg) {
-            unsigned ptIndex = seg->fPtIndex;
-            do {
-                ++seg;
-            } while (seg->fPtIndex == ptIndex);
-            return seg;
-        }
-
     };
 
+    class SegmentBuilder;
+    struct LazyChords;
+    struct Compact;
+    struct CurveTree;
+
     const SkTDArray<Segment>  fSegments;
     const SkTDArray<SkPoint>  fPts; // Points used to define the segments
+    // In kCompact_Storage the segments and points live here instead, and the arrays above are
+    // empty. Use the segment*() accessors rather than either directly.
+    const std::unique_ptr<Compact> fCompact;
 
     const SkScalar fLength;
     const bool fIsClosed;
+    const bool fArcLength;  // segments span whole curves; t is found by inverting arc length
+    // In kLazyChords_LengthMode there is one segment per verb, and each curve's chords are built
+    // at fLazyTolerance the first time a query lands on it.
+    const SkScalar fLazyTolerance;
+    const std::unique_ptr<LazyChords[]> fLazyChords;
+    // Built by the first closest-point query.
+    mutable SkOnce fCurveTreeOnce;
+    mutable std::unique_ptr<CurveTree> fCurveTree;
+    mutable std::atomic<size_t> fLazyBytes{0};  // lazy chords and fCurveTree
 
     SkContourMeasure(SkTDArray<Segment>&& segs, SkTDArray<SkPoint>&& pts,
-                     SkScalar length, bool isClosed);
-    ~SkContourMeasure() override {}
+                     std::unique_ptr<Compact> compact, SkScalar length, bool isClosed,
+                     bool arcLength, SkScalar lazyTolerance);
+    ~SkContourMeasure() override;
 
-    const Segment* distanceToSegment(SkScalar distance, SkScalar* t) const;
+    int segmentCount() const;
+    SkScalar segmentDistance(int index) const;
+    unsigned segmentPtIndex(int index) const;
+    unsigned segmentType(int index) const;
+    SkScalar segmentT(int index) const;
+    const SkPoint* segmentPts(int index) const;  // the points of the curve the segment is on
+    int nextCurve(int index) const;
+
+    int lowerBound(int begin, int end, SkScalar distance) const;
+    int distanceToSegment(SkScalar distance, SkScalar* t) const;
+    int forwardSearch(int start, SkScalar distance) const;
+    void segmentToT(int index, SkScalar distance, SkScalar* t) const;
+    const SkTDArray<Segment>& lazyChords(int index) const;
+    const CurveTree& curveTree() const;
+    SkScalar curveDistance(int curve, SkScalar t) const;
+    bool closestPoint(const SkPoint& point, SkScalar maxDistance, int* hint, SkPoint* closest,
+                      SkScalar* distance, SkVector* tangent) const;
+
+    template <typename Dst>
+    bool segmentTo(SkScalar startD, SkScalar stopD, Dst* dst, bool startWithMoveTo) const;
+    template <typename Dst>
+    bool segmentsTo(const SkScalar startStops[], int count, Dst* dst) const;
+    template <typename Dst>
+    void appendSegment(int seg, SkScalar startT, int stopSeg, SkScalar stopT, Dst* dst,
+                       bool startWithMoveTo) const;
 
     friend class SkContourMeasureIter;
+    friend class SkContourMeasurePriv;
 };
 
 class PK_API SkContourMeasureIter {
 public:
+    /** How curves are measured.
+     *  kChords_LengthMode subdivides each curve until it is nearly flat and measures the chords,
+     *  storing one segment per chord, and maps distance to t by interpolating between chords.
+     *  kArcLength_LengthMode integrates each curve's speed with Gauss-Legendre quadrature,
+     *  storing one segment per curve (more only where a curve bends too sharply for one
+     *  integral), and maps distance to t by Newton iteration. It builds faster, uses far less
+     *  memory and measures more accurately, but each position query costs a few integrals.
+     *  kLazyChords_LengthMode measures each verb by quadrature up front, and only builds a
+     *  curve's chords the first time a query lands on it. length() is available almost at once,
+     *  which suits huge contours that are only sampled in a few places.
+     */
+    enum LengthMode {
+        kChords_LengthMode,
+        kArcLength_LengthMode,
+        kLazyChords_LengthMode,
+    };
+
+    /** How each SkContourMeasure stores its segments.
+     *  kDefault_Storage keeps a 32-bit point index and a 30-bit t for every segment, and its
+     *  own copy of the contour's points.
+     *  kCompact_Storage rounds t to 16 bits, stores point indices as small offsets from a
+     *  shared base, and uses the path's own points whenever the contour doesn't need them
+     *  rearranged (no conics or zero-length verbs), holding a reference to the path so they stay
+     *  unchanged. Positions move by at most the 16-bit rounding of t. It suits keeping many
+     *  measures alive at once. A contour for which it would not save memory, such as a short
+     *  one where its fixed overhead dominates, gets kDefault_Storage instead.
+     */
+    enum Storage {
+        kDefault_Storage,
+        kCompact_Storage,
+    };
+
     SkContourMeasureIter();
     /**
      *  Initialize the Iter with a path.
-     *  The parts of the path that are needed are copied, so the client is free to modify/delete
-     *  the path after this call.
+     *  The parts of the path that are needed are copied or, with kCompact_Storage, shared with
+     *  the path by reference to its points, which SkPath never changes in place. Either way the
+     *  client is free to modify/delete the path after this call.
      *
      *  resScale controls the precision of the measure. values > 1 increase the
      *  precision (and possibly slow down the computation).
      */
-    SkContourMeasureIter(const SkPath& path, bool forceClosed, SkScalar resScale = 1);
+    SkContourMeasureIter(const SkPath& path, bool forceClosed, SkScalar resScale = 1,
+                         LengthMode mode = kChords_LengthMode,
+                         Storage storage = kDefault_Storage);
     ~SkContourMeasureIter();
 
     /**
      *  Reset the Iter with a path.
-     *  The parts of the path that are needed are copied, so the client is free to modify/delete
-     *  the path after this call.
+     *  The parts of the path that are needed are copied or, with kCompact_Storage, shared with
+     *  the path by reference to its points, which SkPath never changes in place. Either way the
+     *  client is free to modify/delete the path after this call.
      */
-    void reset(const SkPath& path, bool forceClosed, SkScalar resScale = 1);
+    void reset(const SkPath& path, bool forceClosed, SkScalar resScale = 1,
+               LengthMode mode = kChords_LengthMode, Storage storage = kDefault_Storage);
 
     /**
      *  Iterates through contours in path, returning a contour-measure object for each contour
@@ -122,6 +242,25 @@ public:
      */
     sk_sp<SkContourMeasure> next();
 
+    /**
+     *  Measures every contour in path, returning the same contours, in the same order, as
+     *  iterating with next() would. The path is split into runs of whole contours which are
+     *  measured on up to maxThreads threads (0 uses one per hardware thread). A path with too few
+     *  verbs to be worth splitting is measured on the calling thread.
+     */
+    static std::vector<sk_sp<SkContourMeasure>> MeasureAll(const SkPath& path, bool forceClosed,
+                                                           SkScalar resScale = 1,
+                                                           LengthMode mode = kChords_LengthMode,
+                                                           int maxThreads = 0,
+                                                           Storage storage = kDefault_Storage);
+
+    /**
+     *  Returns the sum of the lengths of the contours next() would return, measured like
+     *  MeasureAll() but without keeping a SkContourMeasure for each contour.
+     */
+    static SkScalar TotalLength(const SkPath& path, bool forceClosed, SkScalar resScale = 1,
+                                LengthMode mode = kChords_LengthMode, int maxThreads = 0);
+
 private:
     class Impl;
 
@@ -923,6 +923,190 @@ public:
     int toTriangles(float tolerance, const SkRect& clipBounds, std::vector<float>* vertex,
                     bool* isLinear) const;
 
+    /**
+     * Variants of toAATriangles() and toTriangles() for paths made of many separate pieces.
+     * Contours whose bounds don't overlap are grouped apart, each group is triangulated on its own
+     * thread (up to maxThreads, or one per hardware thread if maxThreads is 0), and the vertices
+     * are concatenated. Since such groups can't affect each other's winding, the result covers
+     * the same area as the single threaded version. Paths with an inverse fill type are
+     * triangulated on the calling thread.
+     */
+    int toAATrianglesInParallel(float tolerance, const SkRect& clipBounds,
+                                std::vector<float>* vertex, int maxThreads = 0) const;
+    int toTrianglesInParallel(float tolerance, const SkRect& clipBounds, std::vector<float>* vertex,
+                              bool* isLinear, int maxThreads = 0) const;
+
+    /**
+     * Triangulates only the part of the path inside clipBounds, which is split into a row-major
+     * grid of tiles no bigger than tileWidth x tileHeight (a non-positive size means a single
+     * column or row). The contours are clipped to each tile and the tiles are triangulated
+     * independently on up to maxThreads threads (0 uses one per hardware thread), so tiles can be
+     * streamed and cached separately. tileOffsets receives columns * rows + 1 entries: tile i owns
+     * the vertices [tileOffsets[i], tileOffsets[i + 1]). Returns the number of vertices written.
+     */
+    int toTiledTriangles(float tolerance, const SkRect& clipBounds, float tileWidth,
+                         float tileHeight, std::vector<float>* vertex,
+                         std::vector<int>* tileOffsets, bool* isLinear,
+                         int maxThreads = 0) const;
+
+    /**
+     * Variants of toAATriangles() and toTriangles() that bound the work done on pathological
+     * input. The path is linearized into at most maxPoints points, with every contour keeping at
+     * least three. First the tolerance is raised until the curves fit. If the line segments alone
+     * are too many, the linearized contours are simplified by dropping the points that move the
+     * outline the least. achievedTolerance receives a bound on the distance between the
+     * triangulated outline and the path. A fill has about three vertices per point, plus more
+     * where the path crosses itself. A non-positive maxPoints means no budget.
+     */
+    int toAATriangles(float tolerance, const SkRect& clipBounds, int maxPoints,
+                      std::vector<float>* vertex, float* achievedTolerance) const;
+    int toTriangles(float tolerance, const SkRect& clipBounds, int maxPoints,
+                    std::vector<float>* vertex, bool* isLinear, float* achievedTolerance) const;
+
+    /** \class SkPath::VertexAllocator
+        Provides the memory that toAATriangles() and toTriangles() write their vertices into, so
+        they can go straight into a mapped GPU buffer.
+    */
+    class VertexAllocator {
+    public:
+        virtual ~VertexAllocator() = default;
+
+        /** Returns memory for at least count vertices of stride bytes each, or nullptr to abort
+            the triangulation. count is an upper bound on the vertices that will be written.
+        */
+        virtual void* lock(size_t stride, int count) = 0;
+
+        /** Called once the vertices are written, with the number actually written. */
+        virtual void unlock(int actualCount) = 0;
+    };
+
+    /**
+     * Variants of toAATriangles() and toTriangles() that write the vertices into memory locked
+     * from allocator. lock() is not called if the path produces no triangles. Returns the number
+     * of vertices written.
+     */
+    int toAATriangles(float tolerance, const SkRect& clipBounds,
+                      VertexAllocator* allocator) const;
+    int toTriangles(float tolerance, const SkRect& clipBounds, VertexAllocator* allocator,
+                    bool* isLinear) const;
+
+    /**
+     * Indexed variants of toAATriangles() and toTriangles(). Each vertex of the mesh is written to
+     * vertex only once, and the triangles are written to indices as three indices each. Returns
+     * the number of indices, or 0 if the vertices cannot be addressed by the index type.
+     */
+    int toAATriangles(float tolerance, const SkRect& clipBounds, std::vector<float>* vertex,
+                      std::vector<uint16_t>* indices) const;
+    int toAATriangles(float tolerance, const SkRect& clipBounds, std::vector<float>* vertex,
+                      std::vector<uint32_t>* indices) const;
+    int toTriangles(float tolerance, const SkRect& clipBounds, std::vector<float>* vertex,
+                    std::vector<uint16_t>* indices, bool* isLinear) const;
+    int toTriangles(float tolerance, const SkRect& clipBounds, std::vector<float>* vertex,
+                    std::vector<uint32_t>* indices, bool* isLinear) const;
+
+    /** \struct SkPath::VertexEncoding
+        Describes a 16-bit encoding that toTriangles() and toAATriangles() can write instead of
+        floats. Each vertex is written as uint16_t lanes: x and y, followed for AA by a coverage
+        lane from 0 to 255. A vertex takes 4 bytes, or 6 with coverage, instead of 8 or 12.
+    */
+    struct VertexEncoding {
+        enum Format {
+            kHalf_Format,     //!< x and y are half floats, relative to fOrigin
+            kFixed16_Format,  //!< x and y are int16_t in units of 1 / fScale, relative to fOrigin
+        };
+
+        Format   fFormat = kFixed16_Format;
+        SkPoint  fOrigin = {0, 0};  //!< subtracted from each position, e.g. the tile's top left
+        SkScalar fScale = 1;        //!< fixed point units per device unit; ignored for half floats
+    };
+
+    /**
+     * Variants of toAATriangles() and toTriangles() that write the vertices in a 16-bit encoding.
+     * Fixed point positions are rounded and clamped to the int16_t range. Returns the number of
+     * vertices written.
+     */
+    int toAATriangles(float tolerance, const SkRect& clipBounds, const VertexEncoding& encoding,
+                      std::vector<uint16_t>* vertex) const;
+    int toTriangles(float tolerance, const SkRect& clipBounds, const VertexEncoding& encoding,
+                    std::vector<uint16_t>* vertex, bool* isLinear) const;
+
+    /** Encodes count float vertices from src, as written by toTriangles() (x, y) or by
+        toAATriangles() (x, y, coverage), into dst. dst must have room for count * 2 lanes, or
+        count * 3 with coverage. Use this to encode each tile of toTiledTriangles() relative to
+        its own origin.
+    */
+    static void EncodeVertices(const float src[], int count, bool hasCoverage,
+                               const VertexEncoding& encoding, uint16_t dst[]);
+
+    /** Reusable triangulation of a path under affine matrices; see SkPath::TriangleCache below.
+    */
+    class TriangleCache;
+
+    /** \class SkPath::FlattenSink
+        Receives the polylines produced by SkPath::flatten(), one call per contour.
+    */
+    class FlattenSink {
+    public:
+        virtual ~FlattenSink() = default;
+
+        /** Called once for each contour that contains at least one segment.
+
+            @param pts       device space points of the contour; valid only during the call
+            @param count     number of points in pts
+            @param isClosed  true if the contour ends with kClose_Verb
+        */
+        virtual void polyline(const SkPoint pts[], int count, bool isClosed) = 0;
+    };
+
+    /** Flattens the path into polylines in device space and streams them to sink, one contour at
+        a time. Curves are split into evenly spaced (in the parametric sense) line segments chosen
+        with Wang's formula, so that each polyline stays within tolerance of the true curve after
+        matrix is applied. Paths with perspective are transformed before they are flattened.
+
+        A non-positive tolerance replaces each curve with a line to its end point.
+
+        @param tolerance  maximum distance in device space between a polyline and its curve
+        @param matrix     transform from path space to device space
+        @param sink       receives one polyline per contour
+    */
+    void flatten(SkScalar tolerance, const SkMatrix& matrix, FlattenSink* sink) const;
+
+    /** \struct SkPath::AreaInfo
+        Area enclosed by one or more contours, and its centroid. See computeArea().
+    */
+    struct AreaInfo {
+        SkScalar fArea;      //!< signed area; positive for contours drawn clockwise (kCW)
+        SkPoint  fCentroid;  //!< centroid of the area; (0, 0) if fArea is zero
+    };
+
+    /** \enum SkPath::AreaMode
+        AreaMode chooses what computeArea() measures.
+    */
+    enum AreaMode {
+        kSigned_AreaMode, //!< add up each contour's signed area, ignoring the fill type
+        kFilled_AreaMode, //!< area filled under the fill type, found with Simplify()
+    };
+
+    /** Computes the area and centroid of SkPath exactly from its lines, quads, conics and cubics,
+        without flattening or triangulating them. Each contour is closed with a line back to its
+        start, as when filled.
+
+        In kSigned_AreaMode contours add up their signed areas, so a hole wound against its
+        outline is subtracted, and contours wound the same way that overlap are counted twice.
+        In kFilled_AreaMode the path is first reduced to non-overlapping contours with
+        Simplify(), under the even-odd or winding fill type. The total is then never negative,
+        and each hole's entry in contours has a negative area. Inverse fill types are treated as
+        their non-inverse counterparts.
+
+        @param info      receives the area and centroid of the whole path
+        @param mode      kSigned_AreaMode or kFilled_AreaMode
+        @param contours  if not nullptr, receives the area and centroid of each contour with at
+                         least one segment, in order; after Simplify() in kFilled_AreaMode
+        @return          false if SkPath is not finite, or Simplify() fails
+    */
+    bool computeArea(AreaInfo* info, AreaMode mode = kSigned_AreaMode,
+                     std::vector<AreaInfo>* contours = nullptr) const;
+
     /** \enum SkPath::Verb
         Verb instructs SkPath how to interpret one or more SkPoint and optional conic weight;
         manage contour, and terminate SkPath.
@@ -1034,6 +1218,75 @@ public:
         Verb autoClose(SkPoint pts[2]);
     };
 
+    /** \class SkPath::BatchIter
+        Iterates through SkPath in batches of consecutive segments that share a verb, with their
+        points laid out as a structure of arrays. Code working on several lines or curves at a
+        time, such as SIMD kernels, then branches once per batch instead of once per verb.
+
+        A batch never spans two contours. Moves and closes are not returned; each batch says
+        instead whether it starts or ends its contour. Contours are closed as SkPath::Iter closes
+        them: if a contour ends with kClose_Verb, or forceClose is set, a line back to its start
+        is added when the two points differ.
+    */
+    class PK_API BatchIter {
+    public:
+        /** Most segments in one batch. */
+        static constexpr int kMaxSegments = 64;
+
+        /** Batches are padded to a multiple of kLanes segments; see Batch::fX. */
+        static constexpr int kLanes = 8;
+
+        struct Batch {
+            Verb            fVerb;     //!< kLine_Verb, kQuad_Verb, kConic_Verb or kCubic_Verb
+
+            int             fCount;    //!< number of segments, from 1 to kMaxSegments
+
+            /** fX[i][k] and fY[i][k] are point i of segment k, where point 0 is the segment's
+                start and point 1, 2 or 3 its end; arrays for points the verb doesn't have are
+                nullptr. Past fCount, up to the next multiple of kLanes, the arrays repeat the
+                last segment, so whole kLanes-wide loads stay in bounds and see finite values.
+                The arrays are valid until the next call to next(). */
+            const SkScalar* fX[4];
+            const SkScalar* fY[4];
+            const SkScalar* fWeights;  //!< conic weights, padded the same way; else nullptr
+
+            bool            fContourStart;  //!< first batch of its contour
+            bool            fContourEnd;    //!< last batch of its contour
+            bool            fClosed;        //!< fContourEnd, and the contour was closed
+        };
+
+        /** Iterates over path, which must outlive SkPath::BatchIter and stay unchanged.
+
+            @param path        SkPath to iterate
+            @param forceClose  true to close open contours too
+        */
+        BatchIter(const SkPath& path, bool forceClose);
+
+        /** Fills batch with the next run of segments and returns true, or returns false when
+            the path is exhausted.
+
+            @param batch  storage for the segments; its arrays point into SkPath::BatchIter
+            @return       false if there are no more segments
+        */
+        bool next(Batch* batch);
+
+    private:
+        const SkPoint*  fPts;
+        const uint8_t*  fVerbs;
+        const uint8_t*  fVerbStop;
+        const SkScalar* fConicWeights;
+        SkPoint         fMoveTo;
+        SkPoint         fLastPt;
+        bool            fForceClose;
+        bool            fInContour;  // a batch of the current contour has been returned
+        bool            fCloseLine;  // the next batch starts with the current contour's close
+
+        // kLanes extra entries, so padding can always be written as one kLanes-wide store.
+        alignas(32) SkScalar fXs[4][kMaxSegments + kLanes];
+        alignas(32) SkScalar fYs[4][kMaxSegments + kLanes];
+        alignas(32) SkScalar fWs[kMaxSegments + kLanes];
+    };
+
 private:
     /** \class SkPath::RangeIter
         Iterates through a raw range of path verbs, points, and conics. All values are returned
@@ -1280,4 +1533,53 @@ private:
     friend class SkPathWriter;
     friend class SkOpBuilder;
 };
+
+/** \class SkPath::TriangleCache
+    Triangulates a path once in its own coordinate space and re-emits the triangles under
+    affine matrices, for drawing the same path at many positions and scales.
+*/
+class SkPath::TriangleCache {
+public:
+    /** Triangulates path so that the triangles stay within tolerance of the true path under
+        any affine matrix whose getMaxScale() is no more than maxScale. Curves are flattened
+        with a path space tolerance of tolerance / maxScale, which bounds the segment counts
+        that Wang's formula picks under all such matrices.
+
+        @param path       path to triangulate; copied
+        @param tolerance  maximum distance in device space between the triangles and the path
+        @param maxScale   largest scale factor the triangles are expected to be drawn at
+    */
+    TriangleCache(const SkPath& path, float tolerance, SkScalar maxScale);
+
+    /** Returns true if the cached triangles can be emitted under matrix without being
+        triangulated again, that is, if matrix is affine and scales by at most maxScale().
+    */
+    bool canTransform(const SkMatrix& matrix) const;
+
+    /** Writes the triangles mapped by matrix to vertex, like SkPath::toTriangles() on the
+        transformed path. If matrix scales by more than maxScale(), the path is triangulated
+        again for at least twice the old scale, so that a zoom triggers few retriangulations.
+        Paths with an inverse fill type and matrices with perspective are triangulated in
+        device space on every call, and the cache is left untouched.
+
+        @return  number of vertices written
+    */
+    int toTriangles(const SkMatrix& matrix, const SkRect& clipBounds,
+                    std::vector<float>* vertex, bool* isLinear);
+
+    /** Returns the largest scale factor the cached triangles are valid for. */
+    SkScalar maxScale() const { return fMaxScale; }
+
+    /** Returns the cached triangles in path space, as x, y pairs. */
+    const std::vector<float>& vertices() const { return fVertices; }
+
+private:
+    void triangulate(SkScalar maxScale);
+
+    SkPath fPath;
+    float fTolerance;
+    SkScalar fMaxScale;
+    std::vector<float> fVertices;
+    bool fIsLinear;
+};
 }  // namespace pk
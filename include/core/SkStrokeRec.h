@@ -67,6 +67,15 @@ public:
         return fResScale;
     }
 
+    /**
+     *  If true, applyToPath() returns an outline with no self-overlap (a simple polygon, possibly
+     *  with holes), so it can be exported or combined with Op() without calling Simplify() first.
+     *  Overlap at inner joins is resolved while stroking; Simplify() is only used internally when
+     *  the outline still crosses itself. Default is false.
+     */
+    bool getSimpleOutline() const { return SkToBool(fSimpleOutline); }
+    void setSimpleOutline(bool simple) { fSimpleOutline = simple; }
+
     void setResScale(SkScalar rs) {
         fResScale = rs;
     }
@@ -129,7 +138,8 @@ public:
                (fJoin != SkPaint::kMiter_Join || fMiterLimit == other.fMiterLimit) &&
                fCap == other.fCap &&
                fJoin == other.fJoin &&
-               fStrokeAndFill == other.fStrokeAndFill;
+               fStrokeAndFill == other.fStrokeAndFill &&
+               fSimpleOutline == other.fSimpleOutline;
     }
 
 private:
@@ -138,15 +148,16 @@ private:
     SkScalar        fResScale;
     SkScalar        fWidth;
     SkScalar        fMiterLimit;
-    // The following three members are packed together into a single u32.
+    // The following four members are packed together into a single u32.
     // This is to avoid unnecessary padding and ensure binary equality for
     // hashing (because the padded areas might contain garbage values).
     //
     // fCap and fJoin are larger than needed to avoid having to initialize
     // any pad values
     uint32_t        fCap : 16;             // SkPaint::Cap
-    uint32_t        fJoin : 15;            // SkPaint::Join
+    uint32_t        fJoin : 14;            // SkPaint::Join
     uint32_t        fStrokeAndFill : 1;    // bool
+    uint32_t        fSimpleOutline : 1;    // bool
 };
 PK_END_REQUIRE_DENSE
 }  // namespace pk
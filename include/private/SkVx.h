@@ -528,7 +528,6 @@ SIN Vec<N,float>  ceil(const Vec<N,float>& x) { return map( ceilf, x); }
 SIN Vec<N,float> floor(const Vec<N,float>& x) { return map(floorf, x); }
 SIN Vec<N,float> trunc(const Vec<N,float>& x) { return map(truncf, x); }
 SIN Vec<N,float> round(const Vec<N,float>& x) { return map(roundf, x); }
-SIN Vec<N,float>  sqrt(const Vec<N,float>& x) { return map( sqrtf, x); }
 SIN Vec<N,float>   abs(const Vec<N,float>& x) { return map( fabsf, x); }
 SIN Vec<N,float>   fma(const Vec<N,float>& x,
                        const Vec<N,float>& y,
@@ -556,6 +555,28 @@ SIN Vec<N,int> lrint(const Vec<N,float>& x) {
                 lrint(x.hi));
 }
 
+SI Vec<1,float> sqrt(const Vec<1,float>& x) {
+    return sqrtf(x.val);
+}
+SIN Vec<N,float> sqrt(const Vec<N,float>& x) {
+#if defined(__AVX__)
+    if /*constexpr*/ (N == 8) {
+        return unchecked_bit_pun<Vec<N,float>>(_mm256_sqrt_ps(unchecked_bit_pun<__m256>(x)));
+    }
+#endif
+#if defined(__SSE__)
+    if /*constexpr*/ (N == 4) {
+        return unchecked_bit_pun<Vec<N,float>>(_mm_sqrt_ps(unchecked_bit_pun<__m128>(x)));
+    }
+#elif defined(__aarch64__)
+    if /*constexpr*/ (N == 4) {
+        return unchecked_bit_pun<Vec<N,float>>(vsqrtq_f32(unchecked_bit_pun<float32x4_t>(x)));
+    }
+#endif
+    return join(sqrt(x.lo),
+                sqrt(x.hi));
+}
+
 SIN Vec<N,float> fract(const Vec<N,float>& x) { return x - floor(x); }
 
 // The default logic for to_half/from_half is borrowed from skcms,
@@ -7,9 +7,17 @@
 
 #include "include/core/SkContourMeasure.h"
 #include "include/core/SkPath.h"
+#include "include/private/SkOnce.h"
+#include "include/private/SkTPin.h"
+#include "include/private/SkVx.h"
 #include "src/core/SkGeometry.h"
+#include "src/core/SkParallel.h"
 #include "src/core/SkPathMeasurePriv.h"
 #include "src/core/SkPathPriv.h"
+#include "src/core/SkPointPriv.h"
+
+#include <algorithm>
+#include <iterator>
 
 namespace pk {
 #define kMaxTValue  0x3FFFFFFF
@@ -27,14 +35,15 @@ SkScalar SkContourMeasure::Segment::getScalarT() const {
     return tValue2Scalar(fTValue);
 }
 
-void SkContourMeasure_segTo(const SkPoint pts[], unsigned segType,
-                            SkScalar startT, SkScalar stopT, SkPath* dst) {
+// Dst is either SkPath or SkSegmentSink; both provide the same verb methods.
+template <typename Dst>
+static void seg_to(const SkPoint pts[], unsigned segType,
+                   SkScalar startT, SkScalar stopT, Dst* dst) {
     if (startT == stopT) {
-        if (!dst->isEmpty()) {
+        SkPoint lastPt;
+        if (dst->getLastPt(&lastPt)) {
             /* if the dash as a zero-length on segment, add a corresponding zero-length line.
                The stroke code will add end caps to zero length lines as appropriate */
-            SkPoint lastPt;
-            PkAssertResult(dst->getLastPt(&lastPt));
             dst->lineTo(lastPt);
         }
         return;
@@ -47,8 +56,8 @@ void SkContourMeasure_segTo(const SkPoint pts[], unsigned segType,
             if (PK_Scalar1 == stopT) {
                 dst->lineTo(pts[1]);
             } else {
-                dst->lineTo(SkScalarInterp(pts[0].fX, pts[1].fX, stopT),
-                            SkScalarInterp(pts[0].fY, pts[1].fY, stopT));
+                dst->lineTo(SkPoint::Make(SkScalarInterp(pts[0].fX, pts[1].fX, stopT),
+                                          SkScalarInterp(pts[0].fY, pts[1].fY, stopT)));
             }
             break;
         case kQuad_SegType:
@@ -164,26 +173,127 @@ static bool cubic_too_curvy(const SkPoint pts[4], SkScalar tolerance) {
                          SkScalarInterp(pts[0].fY, pts[3].fY, PK_Scalar1*2/3), tolerance);
 }
 
-class SkContourMeasureIter::Impl {
+// The speed |B'(t)| of one curve, stored as it is in fPts (a conic keeps its weight in pts[1].fX),
+// so kArcLength_LengthMode can integrate it and invert the integral.
+class CurveSpeed {
 public:
-    Impl(const SkPath& path, bool forceClosed, SkScalar resScale)
-        : fPath(path)
-        , fIter(SkPathPriv::Iterate(fPath).begin())
-        , fTolerance(CHEAP_DIST_LIMIT * PkScalarInvert(resScale))
-        , fForceClosed(forceClosed) {}
+    CurveSpeed(const SkPoint pts[], unsigned segType) : fType(segType) {
+        switch (segType) {
+            case kLine_SegType:
+                fC = pts[1] - pts[0];
+                break;
+            case kQuad_SegType:
+                // B'(t) = 2(p1 - p0) + 2t(p2 - 2p1 + p0)
+                fC = (pts[1] - pts[0]) * 2;
+                fB = (pts[2] - pts[1] * 2 + pts[0]) * 2;
+                break;
+            case kCubic_SegType:
+                // B'(t) = 3(p1 - p0) + 6t(p2 - 2p1 + p0) + 3t^2(p3 - 3p2 + 3p1 - p0)
+                fC = (pts[1] - pts[0]) * 3;
+                fB = (pts[2] - pts[1] * 2 + pts[0]) * 6;
+                fA = (pts[3] - pts[2] * 3 + pts[1] * 3 - pts[0]) * 3;
+                break;
+            case kConic_SegType: {
+                // B(t) = N(t) / D(t), N(t) = p0 + 2t(w p1 - p0) + t^2(p0 - 2w p1 + p2),
+                // D(t) = 1 + 2t(w - 1) - 2t^2(w - 1)
+                fW = pts[1].fX;
+                fP0 = pts[0];
+                fC = pts[2] * fW - pts[0];
+                fA = pts[0] - pts[2] * (2 * fW) + pts[3];
+            } break;
+            default:
+                PkDEBUGFAIL("unknown segType");
+        }
+    }
 
-    bool hasNextSegments() const { return fIter != SkPathPriv::Iterate(fPath).end(); }
-    SkContourMeasure* buildSegments();
+    // T is SkScalar or skvx::Vec<4, float>, so four spans can be integrated at once.
+    template <typename T> T operator()(T t) const {
+        T dx, dy;
+        if (fType == kConic_SegType) {
+            T w1 = fW - 1;
+            T denom = 1 + 2 * w1 * t * (1 - t);
+            T dDenom = 2 * w1 * (1 - 2 * t);
+            T scale = 1 / (denom * denom);
+            dx = (2 * (fC.fX + fA.fX * t) * denom -
+                  (fP0.fX + (2 * fC.fX + fA.fX * t) * t) * dDenom) * scale;
+            dy = (2 * (fC.fY + fA.fY * t) * denom -
+                  (fP0.fY + (2 * fC.fY + fA.fY * t) * t) * dDenom) * scale;
+        } else {
+            dx = fC.fX + (fB.fX + fA.fX * t) * t;
+            dy = fC.fY + (fB.fY + fA.fY * t) * t;
+        }
+        using std::sqrt;
+        using skvx::sqrt;
+        return sqrt(dx * dx + dy * dy);
+    }
+
+    // Five point Gauss-Legendre quadrature of the speed over [t0, t1].
+    template <typename T> T length(T t0, T t1) const {
+        static constexpr SkScalar kNodes[] = {0, 0.5384693101f, -0.5384693101f,
+                                              0.9061798459f, -0.9061798459f};
+        static constexpr SkScalar kWeights[] = {0.5688888889f, 0.4786286705f, 0.4786286705f,
+                                                0.2369268851f, 0.2369268851f};
+        if (fType == kLine_SegType) {
+            return fC.length() * (t1 - t0);
+        }
+        T half = (t1 - t0) * 0.5f;
+        T mid = (t1 + t0) * 0.5f;
+        T sum = 0;
+        for (int i = 0; i < 5; ++i) {
+            sum += kWeights[i] * (*this)(mid + half * kNodes[i]);
+        }
+        return sum * half;
+    }
+
+    // Returns the t in [startT, stopT] where the arc length from startT reaches target, given
+    // that the whole span is total long. Newton steps that leave the bracket fall back to
+    // bisection.
+    SkScalar invert(SkScalar startT, SkScalar stopT, SkScalar target, SkScalar total) const {
+        SkScalar t = startT + (stopT - startT) * target / total;
+        if (!SkScalarIsFinite(t) || fType == kLine_SegType) {
+            return t;
+        }
+        const SkScalar tolerance = total * (1.0f / 65536);
+        SkScalar lo = startT, hi = stopT;
+        for (int i = 0; i < 8; ++i) {
+            SkScalar error = this->length(startT, t) - target;
+            if (PkScalarAbs(error) <= tolerance) {
+                break;
+            }
+            if (error < 0) {
+                lo = t;
+            } else {
+                hi = t;
+            }
+            SkScalar speed = (*this)(t);
+            SkScalar next = speed > 0 ? t - error / speed : lo;
+            t = next > lo && next < hi ? next : (lo + hi) * 0.5f;
+        }
+        return t;
+    }
 
 private:
-    SkPath                fPath;
-    SkPathPriv::RangeIter fIter;
-    SkScalar              fTolerance;
-    bool                  fForceClosed;
+    SkVector fA = {0, 0}, fB = {0, 0}, fC = {0, 0};
+    SkPoint  fP0 = {0, 0};
+    SkScalar fW = 1;
+    unsigned fType;
+};
 
-    // temporary
+// Appends the segments for one verb at a time. The iterator uses it to build whole contours, and
+// a kLazyChords_LengthMode measure uses it later to build a single curve's chords.
+class SkContourMeasure::SegmentBuilder {
+public:
+    explicit SegmentBuilder(SkScalar tolerance) : fTolerance(tolerance) {}
+
+    SkTDArray<SkContourMeasure::Segment>& segments() { return fSegments; }
+
+    // Appends the chords of one curve, whose points are laid out as in fPts.
+    SkScalar compute_chord_segs(const SkPoint pts[], unsigned segType, SkScalar distance,
+                                unsigned ptIndex);
+
+protected:
+    SkScalar fTolerance;
     SkTDArray<SkContourMeasure::Segment>  fSegments;
-    SkTDArray<SkPoint>  fPts; // Points used to define the segments
 
     SkScalar compute_line_seg(SkPoint p0, SkPoint p1, SkScalar distance, unsigned ptIndex);
     SkScalar compute_quad_segs(const SkPoint pts[3], SkScalar distance,
@@ -194,10 +304,194 @@ private:
                                 unsigned ptIndex);
     SkScalar compute_cubic_segs(const SkPoint pts[4], SkScalar distance,
                                 int mint, int maxt, unsigned ptIndex);
+    SkScalar compute_arc_segs(const CurveSpeed& speed, unsigned segType, SkScalar distance,
+                              int mint, int maxt, SkScalar length, SkScalar first,
+                              SkScalar second, unsigned ptIndex);
+    SkScalar compute_curve_arc_segs(const SkPoint pts[], unsigned segType, SkScalar distance,
+                                    unsigned ptIndex);
+};
+
+// kCompact_Storage. Distances stay full floats, t is rounded to 16 bits, and each point index is
+// a 6-bit offset from a 32-bit base shared by a block of segments, packed with the segment type.
+// Consecutive segments are at most one cubic apart, so a block of 16 stays within 6 bits.
+struct SkContourMeasure::Compact {
+    static constexpr int kBlockShift = 4;
+    static constexpr int kMaxPtOffset = 63;
+    static constexpr SkScalar kMaxT16 = 0xFFFF;
+
+    int                         fCount = 0;
+    std::unique_ptr<SkScalar[]> fDistances;
+    std::unique_ptr<uint16_t[]> fTValues;
+    std::unique_ptr<uint8_t[]>  fPtOffsets;  // offset from the block's base | SkSegType << 6
+    std::unique_ptr<uint32_t[]> fPtBases;
+
+    // The points are the contour's own run of points in fSource when they match fPts exactly,
+    // except perhaps for the point closing the contour, which fClosePts then stands in for.
+    SkPath                      fSource;
+    const SkPoint*              fPts = nullptr;
+    std::unique_ptr<SkPoint[]>  fOwnedPts;
+    int                         fOwnedPtCount = 0;
+    int                         fClosePtIndex = -1;
+    SkPoint                     fClosePts[2];
+
+    // Returns nullptr if segs can't be encoded, in which case the default storage is used.
+    static std::unique_ptr<Compact> Make(const SkTDArray<Segment>& segs,
+                                         const SkTDArray<SkPoint>& pts, bool isClosed,
+                                         const SkPath& source, const SkPoint* contourPts) {
+        int count = segs.count();
+        int blocks = (count + (1 << kBlockShift) - 1) >> kBlockShift;
+        auto compact = std::make_unique<Compact>();
+        compact->fCount = count;
+        compact->fDistances.reset(new SkScalar[count]);
+        compact->fTValues.reset(new uint16_t[count]);
+        compact->fPtOffsets.reset(new uint8_t[count]);
+        compact->fPtBases.reset(new uint32_t[blocks]);
+        for (int i = 0; i < count; ++i) {
+            const Segment& seg = segs[i];
+            if ((i & ((1 << kBlockShift) - 1)) == 0) {
+                compact->fPtBases[i >> kBlockShift] = seg.fPtIndex;
+            }
+            unsigned offset = seg.fPtIndex - compact->fPtBases[i >> kBlockShift];
+            if (offset > kMaxPtOffset) {
+                return nullptr;
+            }
+            compact->fDistances[i] = seg.fDistance;
+            compact->fTValues[i] = SkToU16(pk_float_round2int(seg.getScalarT() * kMaxT16));
+            compact->fPtOffsets[i] = SkToU8(offset | seg.fType << 6);
+        }
+
+        int ptCount = pts.count();
+        auto iter = SkPathPriv::Iterate(source).begin();
+        const SkPoint* sourcePts = std::get<1>(*iter);
+        auto shared = [&](int n) {
+            return contourPts >= sourcePts && contourPts + n <= sourcePts + source.countPoints() &&
+                   !memcmp(contourPts, pts.begin(), n * sizeof(SkPoint));
+        };
+        if (shared(ptCount)) {
+            compact->fSource = source;
+            compact->fPts = contourPts;
+        } else if (isClosed && ptCount >= 2 && pts[ptCount - 1] == pts[0] &&
+                   shared(ptCount - 1)) {
+            compact->fSource = source;
+            compact->fPts = contourPts;
+            compact->fClosePtIndex = ptCount - 2;
+            compact->fClosePts[0] = pts[ptCount - 2];
+            compact->fClosePts[1] = pts[ptCount - 1];
+        } else {
+            compact->fOwnedPts.reset(new SkPoint[ptCount]);
+            compact->fOwnedPtCount = ptCount;
+            memcpy(compact->fOwnedPts.get(), pts.begin(), ptCount * sizeof(SkPoint));
+            compact->fPts = compact->fOwnedPts.get();
+        }
+        return compact;
+    }
+
+    size_t bytesUsed() const {
+        int blocks = (fCount + (1 << kBlockShift) - 1) >> kBlockShift;
+        return sizeof(Compact) +
+               fCount * (sizeof(SkScalar) + sizeof(uint16_t) + sizeof(uint8_t)) +
+               blocks * sizeof(uint32_t) + fOwnedPtCount * sizeof(SkPoint);
+    }
+};
+
+class SkContourMeasureIter::Impl : SkContourMeasure::SegmentBuilder {
+public:
+    Impl(const SkPath& path, bool forceClosed, SkScalar resScale,
+         SkContourMeasureIter::LengthMode mode, SkContourMeasureIter::Storage storage)
+        : SegmentBuilder(CHEAP_DIST_LIMIT * PkScalarInvert(resScale))
+        , fPath(path)
+        , fIter(SkPathPriv::Iterate(fPath).begin())
+        , fEnd(SkPathPriv::Iterate(fPath).end())
+        , fForceClosed(forceClosed)
+        , fMode(mode)
+        , fStorage(storage) {}
+
+    // Only measures the contours in [begin, end), which must start at a move and end at a move or
+    // at the end of the path. fPath shares the caller's points, so iterators taken from the
+    // caller's path are valid here.
+    void setRange(SkPathPriv::RangeIter begin, SkPathPriv::RangeIter end) {
+        fIter = begin;
+        fEnd = end;
+    }
+
+    bool hasNextSegments() const { return fIter != fEnd; }
+    SkContourMeasure* buildSegments();
+    // Same as buildSegments(), but leaves the segments in this object instead of handing them to
+    // a new SkContourMeasure.
+    bool measureContour(SkScalar* length, bool* isClosed);
+
+private:
+    SkPath                fPath;
+    SkPathPriv::RangeIter fIter;
+    SkPathPriv::RangeIter fEnd;
+    bool                  fForceClosed;
+    SkContourMeasureIter::LengthMode fMode;
+    SkContourMeasureIter::Storage    fStorage;
+
+    // temporary
+    SkTDArray<SkPoint>  fPts; // Points used to define the segments
+    const SkPoint*      fContourPts = nullptr; // fPath's points, starting at the contour's move
+
+    SkScalar compute_curve_segs(const SkPoint pts[], unsigned segType, SkScalar distance,
+                                unsigned ptIndex);
 };
 
-SkScalar SkContourMeasureIter::Impl::compute_quad_segs(const SkPoint pts[3], SkScalar distance,
-                                                       int mint, int maxt, unsigned ptIndex) {
+// A span is split when subdividing it changes its integral by more than this fraction of the
+// chord tolerance. That is much tighter than the chords themselves manage, yet most curves still
+// need only one or two segments.
+#define ARC_LENGTH_TOLERANCE    (PK_Scalar1/64)
+
+SkScalar SkContourMeasure::SegmentBuilder::compute_arc_segs(const CurveSpeed& speed,
+                                                            unsigned segType, SkScalar distance,
+                                                            int mint, int maxt, SkScalar length,
+                                                            SkScalar first, SkScalar second,
+                                                            unsigned ptIndex) {
+    int halft = (mint + maxt) >> 1;
+    SkScalar t0 = tValue2Scalar(mint), t2 = tValue2Scalar(halft), t4 = tValue2Scalar(maxt);
+    SkScalar t1 = (t0 + t2) * 0.5f, t3 = (t2 + t4) * 0.5f;
+    // Near a cusp the whole span and its halves can agree by accident while both are wrong,
+    // so the quarters have to agree as well.
+    skvx::Vec<4, float> quarters = speed.length(skvx::Vec<4, float>{t0, t1, t2, t3},
+                                                skvx::Vec<4, float>{t1, t2, t3, t4});
+    const SkScalar tolerance = fTolerance * ARC_LENGTH_TOLERANCE;
+    if (tspan_big_enough(maxt - mint) &&
+        (PkScalarAbs(first + second - length) > tolerance ||
+         PkScalarAbs(quarters[0] + quarters[1] + quarters[2] + quarters[3] - (first + second)) >
+                 tolerance)) {
+        distance = this->compute_arc_segs(speed, segType, distance, mint, halft, first,
+                                          quarters[0], quarters[1], ptIndex);
+        distance = this->compute_arc_segs(speed, segType, distance, halft, maxt, second,
+                                          quarters[2], quarters[3], ptIndex);
+    } else {
+        // Store the single integral over the span, which is what segmentToT() inverts.
+        SkScalar prevD = distance;
+        distance += length;
+        if (distance > prevD) {
+            SkContourMeasure::Segment* seg = fSegments.append();
+            seg->fDistance = distance;
+            seg->fPtIndex = ptIndex;
+            seg->fType = segType;
+            seg->fTValue = maxt;
+        }
+    }
+    return distance;
+}
+
+SkScalar SkContourMeasure::SegmentBuilder::compute_curve_arc_segs(const SkPoint pts[],
+                                                                  unsigned segType,
+                                                                  SkScalar distance,
+                                                                  unsigned ptIndex) {
+    CurveSpeed speed(pts, segType);
+    // The whole curve and its two halves.
+    skvx::Vec<4, float> lengths = speed.length(skvx::Vec<4, float>{0, 0, 0.5f, 0},
+                                               skvx::Vec<4, float>{1, 0.5f, 1, 0});
+    return this->compute_arc_segs(speed, segType, distance, 0, kMaxTValue, lengths[0],
+                                  lengths[1], lengths[2], ptIndex);
+}
+
+SkScalar SkContourMeasure::SegmentBuilder::compute_quad_segs(const SkPoint pts[3],
+                                                             SkScalar distance, int mint, int maxt,
+                                                             unsigned ptIndex) {
     if (tspan_big_enough(maxt - mint) && quad_too_curvy(pts, fTolerance)) {
         SkPoint tmp[5];
         int     halft = (mint + maxt) >> 1;
@@ -220,10 +514,11 @@ SkScalar SkContourMeasureIter::Impl::compute_quad_segs(const SkPoint pts[3], SkS
     return distance;
 }
 
-SkScalar SkContourMeasureIter::Impl::compute_conic_segs(const SkConic& conic, SkScalar distance,
-                                                        int mint, const SkPoint& minPt,
-                                                        int maxt, const SkPoint& maxPt,
-                                                        unsigned ptIndex) {
+SkScalar SkContourMeasure::SegmentBuilder::compute_conic_segs(const SkConic& conic,
+                                                              SkScalar distance, int mint,
+                                                              const SkPoint& minPt, int maxt,
+                                                              const SkPoint& maxPt,
+                                                              unsigned ptIndex) {
     int halft = (mint + maxt) >> 1;
     SkPoint halfPt = conic.evalAt(tValue2Scalar(halft));
     if (!halfPt.isFinite()) {
@@ -247,8 +542,9 @@ SkScalar SkContourMeasureIter::Impl::compute_conic_segs(const SkConic& conic, Sk
     return distance;
 }
 
-SkScalar SkContourMeasureIter::Impl::compute_cubic_segs(const SkPoint pts[4], SkScalar distance,
-                                                        int mint, int maxt, unsigned ptIndex) {
+SkScalar SkContourMeasure::SegmentBuilder::compute_cubic_segs(const SkPoint pts[4],
+                                                              SkScalar distance, int mint, int maxt,
+                                                              unsigned ptIndex) {
     if (tspan_big_enough(maxt - mint) && cubic_too_curvy(pts, fTolerance)) {
         SkPoint tmp[7];
         int     halft = (mint + maxt) >> 1;
@@ -271,8 +567,8 @@ SkScalar SkContourMeasureIter::Impl::compute_cubic_segs(const SkPoint pts[4], Sk
     return distance;
 }
 
-SkScalar SkContourMeasureIter::Impl::compute_line_seg(SkPoint p0, SkPoint p1, SkScalar distance,
-                                                      unsigned ptIndex) {
+SkScalar SkContourMeasure::SegmentBuilder::compute_line_seg(SkPoint p0, SkPoint p1,
+                                                            SkScalar distance, unsigned ptIndex) {
     SkScalar d = SkPoint::Distance(p0, p1);
     SkScalar prevD = distance;
     distance += d;
@@ -286,7 +582,51 @@ SkScalar SkContourMeasureIter::Impl::compute_line_seg(SkPoint p0, SkPoint p1, Sk
     return distance;
 }
 
-SkContourMeasure* SkContourMeasureIter::Impl::buildSegments() {
+SkScalar SkContourMeasure::SegmentBuilder::compute_chord_segs(const SkPoint pts[], unsigned segType,
+                                                              SkScalar distance, unsigned ptIndex) {
+    switch (segType) {
+        case kQuad_SegType:
+            return this->compute_quad_segs(pts, distance, 0, kMaxTValue, ptIndex);
+        case kConic_SegType: {
+            const SkConic conic(pts[0], pts[2], pts[3], pts[1].fX);
+            return this->compute_conic_segs(conic, distance, 0, conic.fPts[0],
+                                            kMaxTValue, conic.fPts[2], ptIndex);
+        }
+        case kCubic_SegType:
+            return this->compute_cubic_segs(pts, distance, 0, kMaxTValue, ptIndex);
+        default:
+            PkDEBUGFAIL("unknown segType");
+            return distance;
+    }
+}
+
+SkScalar SkContourMeasureIter::Impl::compute_curve_segs(const SkPoint pts[], unsigned segType,
+                                                        SkScalar distance, unsigned ptIndex) {
+    switch (fMode) {
+        case kChords_LengthMode:
+            return this->compute_chord_segs(pts, segType, distance, ptIndex);
+        case kArcLength_LengthMode:
+            return this->compute_curve_arc_segs(pts, segType, distance, ptIndex);
+        case kLazyChords_LengthMode: {
+            // Measure by quadrature but keep a single segment; lazyChords() fills in the chords.
+            int count = fSegments.count();
+            SkScalar prevD = distance;
+            distance = this->compute_curve_arc_segs(pts, segType, distance, ptIndex);
+            fSegments.setCount(count);
+            if (distance > prevD) {
+                SkContourMeasure::Segment* seg = fSegments.append();
+                seg->fDistance = distance;
+                seg->fPtIndex = ptIndex;
+                seg->fType = segType;
+                seg->fTValue = kMaxTValue;
+            }
+            return distance;
+        }
+    }
+    return distance;
+}
+
+bool SkContourMeasureIter::Impl::measureContour(SkScalar* length, bool* isClosed) {
     int         ptIndex = -1;
     SkScalar    distance = 0;
     bool        haveSeenClose = fForceClosed;
@@ -300,8 +640,8 @@ SkContourMeasure* SkContourMeasureIter::Impl::buildSegments() {
      *  We do this check below, and in compute_quad_segs and compute_cubic_segs
      */
 
-    fSegments.reset();
-    fPts.reset();
+    fSegments.rewind();
+    fPts.rewind();
 
     auto end = SkPathPriv::Iterate(fPath).end();
     for (; fIter != end; ++fIter) {
@@ -315,6 +655,7 @@ SkContourMeasure* SkContourMeasureIter::Impl::buildSegments() {
             case SkPathVerb::kMove:
                 ptIndex += 1;
                 fPts.append(1, pts);
+                fContourPts = pts;
                 haveSeenMoveTo = true;
                 break;
 
@@ -329,7 +670,7 @@ SkContourMeasure* SkContourMeasureIter::Impl::buildSegments() {
 
             case SkPathVerb::kQuad: {
                 SkScalar prevD = distance;
-                distance = this->compute_quad_segs(pts, distance, 0, kMaxTValue, ptIndex);
+                distance = this->compute_curve_segs(pts, kQuad_SegType, distance, ptIndex);
                 if (distance > prevD) {
                     fPts.append(2, pts + 1);
                     ptIndex += 2;
@@ -338,9 +679,9 @@ SkContourMeasure* SkContourMeasureIter::Impl::buildSegments() {
 
             case SkPathVerb::kConic: {
                 const SkConic conic(pts, *w);
+                const SkPoint conicPts[] = {pts[0], {conic.fW, 0}, pts[1], pts[2]};
                 SkScalar prevD = distance;
-                distance = this->compute_conic_segs(conic, distance, 0, conic.fPts[0],
-                                                    kMaxTValue, conic.fPts[2], ptIndex);
+                distance = this->compute_curve_segs(conicPts, kConic_SegType, distance, ptIndex);
                 if (distance > prevD) {
                     // we store the conic weight in our next point, followed by the last 2 pts
                     // thus to reconstitue a conic, you'd need to say
@@ -353,7 +694,7 @@ SkContourMeasure* SkContourMeasureIter::Impl::buildSegments() {
 
             case SkPathVerb::kCubic: {
                 SkScalar prevD = distance;
-                distance = this->compute_cubic_segs(pts, distance, 0, kMaxTValue, ptIndex);
+                distance = this->compute_curve_segs(pts, kCubic_SegType, distance, ptIndex);
                 if (distance > prevD) {
                     fPts.append(3, pts + 1);
                     ptIndex += 3;
@@ -368,10 +709,10 @@ SkContourMeasure* SkContourMeasureIter::Impl::buildSegments() {
     }
 
     if (!SkScalarIsFinite(distance)) {
-        return nullptr;
+        return false;
     }
     if (fSegments.count() == 0) {
-        return nullptr;
+        return false;
     }
 
     if (haveSeenClose) {
@@ -383,7 +724,33 @@ SkContourMeasure* SkContourMeasureIter::Impl::buildSegments() {
         }
     }
 
-    return new SkContourMeasure(std::move(fSegments), std::move(fPts), distance, haveSeenClose);
+    *length = distance;
+    *isClosed = haveSeenClose;
+    return true;
+}
+
+SkContourMeasure* SkContourMeasureIter::Impl::buildSegments() {
+    SkScalar length;
+    bool isClosed;
+    if (!this->measureContour(&length, &isClosed)) {
+        return nullptr;
+    }
+    if (fStorage == kCompact_Storage) {
+        // The full-size arrays stay here to be reused by the next contour. Short contours, whose
+        // arrays are small next to the compact form's fixed overhead, keep them instead.
+        size_t defaultBytes = fSegments.reserved() * sizeof(SkContourMeasure::Segment) +
+                              fPts.reserved() * sizeof(SkPoint);
+        auto compact = SkContourMeasure::Compact::Make(fSegments, fPts, isClosed, fPath,
+                                                       fContourPts);
+        if (compact && compact->bytesUsed() < defaultBytes) {
+            return new SkContourMeasure({}, {}, std::move(compact), length, isClosed,
+                                        fMode == kArcLength_LengthMode,
+                                        fMode == kLazyChords_LengthMode ? fTolerance : 0);
+        }
+    }
+    return new SkContourMeasure(std::move(fSegments), std::move(fPts), nullptr, length, isClosed,
+                                fMode == kArcLength_LengthMode,
+                                fMode == kLazyChords_LengthMode ? fTolerance : 0);
 }
 
 static void compute_pos_tan(const SkPoint pts[], unsigned segType,
@@ -429,17 +796,19 @@ SkContourMeasureIter::SkContourMeasureIter() {
 }
 
 SkContourMeasureIter::SkContourMeasureIter(const SkPath& path, bool forceClosed,
-                                           SkScalar resScale) {
-    this->reset(path, forceClosed, resScale);
+                                           SkScalar resScale, LengthMode mode,
+                                           Storage storage) {
+    this->reset(path, forceClosed, resScale, mode, storage);
 }
 
 SkContourMeasureIter::~SkContourMeasureIter() {}
 
 /** Assign a new path, or null to have none.
 */
-void SkContourMeasureIter::reset(const SkPath& path, bool forceClosed, SkScalar resScale) {
+void SkContourMeasureIter::reset(const SkPath& path, bool forceClosed, SkScalar resScale,
+                                 LengthMode mode, Storage storage) {
     if (path.isFinite()) {
-        fImpl = std::make_unique<Impl>(path, forceClosed, resScale);
+        fImpl = std::make_unique<Impl>(path, forceClosed, resScale, mode, storage);
     } else {
         fImpl.reset();
     }
@@ -458,64 +827,352 @@ sk_sp<SkContourMeasure> SkContourMeasureIter::next() {
     return nullptr;
 }
 
+// Returns where each run of whole contours starts, followed by the end of the path. A run holds
+// about kRunsPerThread-th of a thread's share of the verbs, so uneven contours still balance.
+static std::vector<SkPathPriv::RangeIter> split_into_runs(const SkPath& path, int threads) {
+    constexpr int kRunsPerThread = 8;
+    int runVerbs = std::max(1, path.countVerbs() / (threads * kRunsPerThread));
+    std::vector<SkPathPriv::RangeIter> starts;
+    SkPathPriv::Iterate iterate(path);
+    auto end = iterate.end();
+    int verbs = runVerbs;
+    for (auto iter = iterate.begin(); iter != end; ++iter, ++verbs) {
+        if (verbs >= runVerbs && std::get<0>(*iter) == SkPathVerb::kMove) {
+            starts.push_back(iter);
+            verbs = 0;
+        }
+    }
+    starts.push_back(end);
+    return starts;
+}
+
+// Returns how many threads to measure path on, where 1 means measuring it inline. Below
+// kMinVerbsPerThread verbs per thread, starting the threads and splitting the path into runs
+// costs more than they save.
+static int measure_threads(const SkPath& path, int maxThreads) {
+    constexpr int kMinVerbsPerThread = 4096;
+    int threads = path.countVerbs() / kMinVerbsPerThread;
+    // Skip asking for the hardware's thread count, which isn't free, when it can't matter.
+    return threads > 1 ? std::min(threads, SkResolveThreadCount(maxThreads)) : 1;
+}
+
+std::vector<sk_sp<SkContourMeasure>> SkContourMeasureIter::MeasureAll(const SkPath& path,
+                                                                      bool forceClosed,
+                                                                      SkScalar resScale,
+                                                                      LengthMode mode,
+                                                                      int maxThreads,
+                                                                      Storage storage) {
+    std::vector<sk_sp<SkContourMeasure>> contours;
+    if (!path.isFinite()) {
+        return contours;
+    }
+    int threads = measure_threads(path, maxThreads);
+    if (threads == 1) {
+        Impl impl(path, forceClosed, resScale, mode, storage);
+        while (impl.hasNextSegments()) {
+            if (SkContourMeasure* cm = impl.buildSegments()) {
+                contours.push_back(sk_sp<SkContourMeasure>(cm));
+            }
+        }
+        return contours;
+    }
+    auto starts = split_into_runs(path, threads);
+    int count = static_cast<int>(starts.size()) - 1;
+    std::vector<std::vector<sk_sp<SkContourMeasure>>> runs(count);
+    SkParallelFor(count, threads, [&](int i) {
+        Impl impl(path, forceClosed, resScale, mode, storage);
+        impl.setRange(starts[i], starts[i + 1]);
+        while (impl.hasNextSegments()) {
+            if (SkContourMeasure* cm = impl.buildSegments()) {
+                runs[i].push_back(sk_sp<SkContourMeasure>(cm));
+            }
+        }
+    });
+    size_t total = 0;
+    for (const auto& run : runs) {
+        total += run.size();
+    }
+    contours.reserve(total);
+    for (auto& run : runs) {
+        std::move(run.begin(), run.end(), std::back_inserter(contours));
+    }
+    return contours;
+}
+
+SkScalar SkContourMeasureIter::TotalLength(const SkPath& path, bool forceClosed,
+                                           SkScalar resScale, LengthMode mode, int maxThreads) {
+    if (!path.isFinite()) {
+        return 0;
+    }
+    int threads = measure_threads(path, maxThreads);
+    if (threads == 1) {
+        Impl impl(path, forceClosed, resScale, mode, kDefault_Storage);
+        SkScalar total = 0, length;
+        bool isClosed;
+        while (impl.hasNextSegments()) {
+            if (impl.measureContour(&length, &isClosed)) {
+                total += length;
+            }
+        }
+        return total;
+    }
+    auto starts = split_into_runs(path, threads);
+    int count = static_cast<int>(starts.size()) - 1;
+    std::vector<std::vector<SkScalar>> runs(count);
+    SkParallelFor(count, threads, [&](int i) {
+        // One Impl per run reuses its segment storage from contour to contour.
+        Impl impl(path, forceClosed, resScale, mode, kDefault_Storage);
+        impl.setRange(starts[i], starts[i + 1]);
+        SkScalar length;
+        bool isClosed;
+        while (impl.hasNextSegments()) {
+            if (impl.measureContour(&length, &isClosed)) {
+                runs[i].push_back(length);
+            }
+        }
+    });
+    // Add the contours up in path order, so the sum matches adding up next()'s lengths.
+    SkScalar total = 0;
+    for (const auto& run : runs) {
+        for (SkScalar length : run) {
+            total += length;
+        }
+    }
+    return total;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-SkContourMeasure::SkContourMeasure(SkTDArray<Segment>&& segs, SkTDArray<SkPoint>&& pts, SkScalar length, bool isClosed)
+struct SkContourMeasure::LazyChords {
+    SkOnce             fOnce;
+    SkTDArray<Segment> fChords;
+};
+
+// Bounding boxes of the contour's curves, split at the median of the longer axis down to a few
+// curves per leaf.
+struct SkContourMeasure::CurveTree {
+    static constexpr int kMaxLeafCurves = 4;
+
+    struct Node {
+        SkRect fBounds;
+        int    fFirst;  // a leaf's first curve in fCurves, or an inner node's first child
+        int    fCount;  // a leaf's number of curves, or 0 for an inner node
+    };
+
+    struct Item {
+        SkRect fBounds;
+        int    fCurve;
+    };
+
+    SkTDArray<Node> fNodes;
+    SkTDArray<Item> fCurves;  // fCurve is the first segment of each curve
+
+    void build(int node, Item items[], int count) {
+        SkRect bounds = items[0].fBounds;
+        for (int i = 1; i < count; ++i) {
+            bounds.join(items[i].fBounds);
+        }
+        fNodes[node].fBounds = bounds;
+        if (count <= kMaxLeafCurves) {
+            fNodes[node].fFirst = fCurves.count();
+            fNodes[node].fCount = count;
+            fCurves.append(count, items);
+            return;
+        }
+        bool splitX = bounds.width() > bounds.height();
+        std::nth_element(items, items + count / 2, items + count,
+                         [splitX](const Item& a, const Item& b) {
+                             return splitX ? a.fBounds.centerX() < b.fBounds.centerX()
+                                           : a.fBounds.centerY() < b.fBounds.centerY();
+                         });
+        int children = fNodes.count();
+        fNodes.append(2);
+        fNodes[node].fFirst = children;
+        fNodes[node].fCount = 0;
+        this->build(children, items, count / 2);
+        this->build(children + 1, items + count / 2, count - count / 2);
+    }
+
+    size_t bytesUsed() const {
+        return sizeof(CurveTree) + fNodes.reserved() * sizeof(Node) +
+               fCurves.reserved() * sizeof(Item);
+    }
+};
+
+SkContourMeasure::SkContourMeasure(SkTDArray<Segment>&& segs, SkTDArray<SkPoint>&& pts,
+                                   std::unique_ptr<Compact> compact, SkScalar length,
+                                   bool isClosed, bool arcLength, SkScalar lazyTolerance)
     : fSegments(std::move(segs))
     , fPts(std::move(pts))
+    , fCompact(std::move(compact))
     , fLength(length)
     , fIsClosed(isClosed)
+    , fArcLength(arcLength)
+    , fLazyTolerance(lazyTolerance)
+    , fLazyChords(lazyTolerance > 0 ? new LazyChords[this->segmentCount()] : nullptr)
     {}
 
-template <typename T, typename K>
-int SkTKSearch(const T base[], int count, const K& key) {
-    if (count <= 0) {
-        return ~0;
+SkContourMeasure::~SkContourMeasure() {}
+
+inline int SkContourMeasure::segmentCount() const {
+    return fCompact ? fCompact->fCount : fSegments.count();
+}
+
+inline SkScalar SkContourMeasure::segmentDistance(int index) const {
+    return fCompact ? fCompact->fDistances[index] : fSegments[index].fDistance;
+}
+
+inline unsigned SkContourMeasure::segmentPtIndex(int index) const {
+    if (fCompact) {
+        return fCompact->fPtBases[index >> Compact::kBlockShift] +
+               (fCompact->fPtOffsets[index] & Compact::kMaxPtOffset);
     }
+    return fSegments[index].fPtIndex;
+}
 
-    unsigned lo = 0;
-    unsigned hi = count - 1;
+inline unsigned SkContourMeasure::segmentType(int index) const {
+    return fCompact ? fCompact->fPtOffsets[index] >> 6 : fSegments[index].fType;
+}
 
-    while (lo < hi) {
-        unsigned mid = (hi + lo) >> 1;
-        if (base[mid].fDistance < key) {
-            lo = mid + 1;
-        } else {
-            hi = mid;
-        }
+inline SkScalar SkContourMeasure::segmentT(int index) const {
+    // Divide rather than multiply by the reciprocal so the end of a curve is exactly 1.
+    return fCompact ? fCompact->fTValues[index] / Compact::kMaxT16
+                    : fSegments[index].getScalarT();
+}
+
+inline const SkPoint* SkContourMeasure::segmentPts(int index) const {
+    unsigned ptIndex = this->segmentPtIndex(index);
+    if (fCompact) {
+        return static_cast<int>(ptIndex) == fCompact->fClosePtIndex ? fCompact->fClosePts
+                                                                    : fCompact->fPts + ptIndex;
     }
+    return &fPts[ptIndex];
+}
 
-    if (base[hi].fDistance < key) {
-        hi += 1;
-        hi = ~hi;
-    } else if (key < base[hi].fDistance) {
-        hi = ~hi;
+int SkContourMeasure::nextCurve(int index) const {
+    unsigned ptIndex = this->segmentPtIndex(index);
+    do {
+        ++index;
+    } while (this->segmentPtIndex(index) == ptIndex);
+    return index;
+}
+
+size_t SkContourMeasure::approximateBytesUsed() const {
+    size_t bytes = sizeof(*this) + fSegments.reserved() * sizeof(Segment) +
+                   fPts.reserved() * sizeof(SkPoint);
+    if (fCompact) {
+        bytes += fCompact->bytesUsed();
     }
-    return hi;
+    if (fLazyChords) {
+        bytes += this->segmentCount() * sizeof(LazyChords);
+    }
+    return bytes + fLazyBytes.load(std::memory_order_relaxed);
 }
 
-const SkContourMeasure::Segment* SkContourMeasure::distanceToSegment( SkScalar distance,
-                                                                     SkScalar* t) const {
-    const Segment*  seg = fSegments.begin();
-    int             count = fSegments.count();
+// Builds the chords of the curve behind segment index the first time they are asked for. They
+// are stretched to the length measured up front, so distances still line up with the
+// neighbouring segments.
+const SkTDArray<SkContourMeasure::Segment>& SkContourMeasure::lazyChords(int index) const {
+    LazyChords& lazy = fLazyChords[index];
+    lazy.fOnce([&] {
+        SkScalar startD = index > 0 ? this->segmentDistance(index - 1) : 0;
+        SkScalar stopD = this->segmentDistance(index);
+        unsigned ptIndex = this->segmentPtIndex(index);
+        unsigned segType = this->segmentType(index);
+        SegmentBuilder builder(fLazyTolerance);
+        SkScalar chordD = builder.compute_chord_segs(this->segmentPts(index), segType, startD,
+                                                     ptIndex);
+        lazy.fChords = std::move(builder.segments());
+        SkScalar scale = (stopD - startD) / (chordD - startD);
+        for (Segment& chord : lazy.fChords) {
+            chord.fDistance = startD + (chord.fDistance - startD) * scale;
+        }
+        if (lazy.fChords.count() == 0) {
+            Segment* seg = lazy.fChords.append();
+            seg->fPtIndex = ptIndex;
+            seg->fType = segType;
+            seg->fTValue = kMaxTValue;
+        }
+        lazy.fChords.back().fDistance = stopD;
+        fLazyBytes.fetch_add(lazy.fChords.reserved() * sizeof(Segment),
+                             std::memory_order_relaxed);
+    });
+    return lazy.fChords;
+}
+
+// Returns the first segment in [begin, end) that reaches distance, or the last segment if none
+// does.
+int SkContourMeasure::lowerBound(int begin, int end, SkScalar distance) const {
+    int index;
+    if (fCompact) {
+        const SkScalar* distances = fCompact->fDistances.get();
+        index = static_cast<int>(std::lower_bound(distances + begin, distances + end, distance) -
+                                 distances);
+    } else {
+        const Segment* segs = fSegments.begin();
+        auto below = [](const Segment& seg, SkScalar d) { return seg.fDistance < d; };
+        index = static_cast<int>(std::lower_bound(segs + begin, segs + end, distance, below) -
+                                 segs);
+    }
+    return std::min(index, this->segmentCount() - 1);
+}
+
+int SkContourMeasure::distanceToSegment(SkScalar distance, SkScalar* t) const {
+    int index = this->lowerBound(0, this->segmentCount(), distance);
+    this->segmentToT(index, distance, t);
+    return index;
+}
+
+// Finds the same segment as distanceToSegment() for a distance no less than the one that found
+// start, by galloping forward from start. A run of increasing distances then costs about log(gap)
+// per step instead of log(count).
+int SkContourMeasure::forwardSearch(int start, SkScalar distance) const {
+    int count = this->segmentCount();
+    PkASSERT(start == 0 || this->segmentDistance(start - 1) < distance);
+    int lo = start, hi = start;
+    // Past a few doublings the sample is far ahead, so just search everything after it.
+    for (int step = 1; hi < count && this->segmentDistance(hi) < distance; step *= 2) {
+        lo = hi + 1;
+        hi = step < 16 ? std::min(start + step, count) : count;
+    }
+    return this->lowerBound(lo, hi, distance);
+}
 
-    int index = SkTKSearch<Segment, SkScalar>(seg, count, distance);
-    // don't care if we hit an exact match or not, so we xor index if it is negative
-    index ^= (index >> 31);
-    seg = &seg[index];
+void SkContourMeasure::segmentToT(int index, SkScalar distance, SkScalar* t) const {
+    if (fLazyChords && this->segmentType(index) != kLine_SegType) {
+        // Same interpolation as below, between the chords of this one curve.
+        const SkTDArray<Segment>& chords = this->lazyChords(index);
+        auto below = [](const Segment& seg, SkScalar d) { return seg.fDistance < d; };
+        int chord = static_cast<int>(
+                std::lower_bound(chords.begin(), chords.end(), distance, below) - chords.begin());
+        chord = std::min(chord, chords.count() - 1);
+        SkScalar startT = 0, startD = index > 0 ? this->segmentDistance(index - 1) : 0;
+        if (chord > 0) {
+            startT = chords[chord - 1].getScalarT();
+            startD = chords[chord - 1].fDistance;
+        }
+        *t = startT + (chords[chord].getScalarT() - startT) * (distance - startD) /
+                      (chords[chord].fDistance - startD);
+        return;
+    }
 
     // now interpolate t-values with the prev segment (if possible)
     SkScalar    startT = 0, startD = 0;
+    SkScalar    stopT = this->segmentT(index), stopD = this->segmentDistance(index);
     // check if the prev segment is legal, and references the same set of points
     if (index > 0) {
-        startD = seg[-1].fDistance;
-        if (seg[-1].fPtIndex == seg->fPtIndex) {
-            startT = seg[-1].getScalarT();
+        startD = this->segmentDistance(index - 1);
+        if (this->segmentPtIndex(index - 1) == this->segmentPtIndex(index)) {
+            startT = this->segmentT(index - 1);
         }
     }
 
-    *t = startT + (seg->getScalarT() - startT) * (distance - startD) / (seg->fDistance - startD);
-    return seg;
+    if (fArcLength) {
+        *t = CurveSpeed(this->segmentPts(index), this->segmentType(index))
+                     .invert(startT, stopT, distance - startD, stopD - startD);
+        return;
+    }
+    *t = startT + (stopT - startT) * (distance - startD) / (stopD - startD);
 }
 
 bool SkContourMeasure::getPosTan(SkScalar distance, SkPoint* pos, SkVector* tangent) const {
@@ -532,16 +1189,504 @@ bool SkContourMeasure::getPosTan(SkScalar distance, SkPoint* pos, SkVector* tang
         distance = length;
     }
 
-    SkScalar        t;
-    const Segment*  seg = this->distanceToSegment(distance, &t);
+    SkScalar    t;
+    int         index = this->distanceToSegment(distance, &t);
     if (SkScalarIsNaN(t)) {
         return false;
     }
 
-    compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, t, pos, tangent);
+    compute_pos_tan(this->segmentPts(index), this->segmentType(index), t, pos, tangent);
+    return true;
+}
+
+// Same as tangent->normalize() on four tangents at once, including the trip through doubles.
+static void normalize4(skvx::Vec<4, float>* x, skvx::Vec<4, float>* y) {
+    for (int k = 0; k < 4; ++k) {
+        double dx = (*x)[k], dy = (*y)[k];
+        double dscale = 1.0 / sqrt(dx * dx + dy * dy);
+        float nx = static_cast<float>(dx * dscale), ny = static_cast<float>(dy * dscale);
+        bool ok = SkScalarIsFinite(nx) && SkScalarIsFinite(ny) && (nx != 0 || ny != 0);
+        (*x)[k] = ok ? nx : 0;
+        (*y)[k] = ok ? ny : 0;
+    }
+}
+
+// Evaluates count samples of one segment, four at a time, with the same arithmetic as
+// compute_pos_tan() so the results match it exactly. Conics, runs too short to pay for the setup,
+// and the end points where the scalar code special cases degenerate tangents go through
+// compute_pos_tan() itself.
+static void compute_pos_tans(const SkPoint pts[], unsigned segType, const SkScalar t[], int count,
+                             SkPoint pos[], SkVector tan[]) {
+    using float4 = skvx::Vec<4, float>;
+    if (segType == kConic_SegType || count < 4) {
+        for (int i = 0; i < count; ++i) {
+            compute_pos_tan(pts, segType, t[i], pos ? &pos[i] : nullptr, tan ? &tan[i] : nullptr);
+        }
+        return;
+    }
+    float4 x0 = pts[0].fX, y0 = pts[0].fY, x1 = pts[1].fX, y1 = pts[1].fY;
+    // Position coefficients in Horner form, highest power first, and the same for the tangent.
+    float4 pa[2], pb[2], pc[2], pd[2], ta[2], tb[2], tc[2];
+    SkVector lineTan = {0, 0};
+    int degree = 1;
+    if (segType == kLine_SegType) {
+        lineTan.setNormalize(pts[1].fX - pts[0].fX, pts[1].fY - pts[0].fY);
+    } else if (segType == kQuad_SegType) {
+        degree = 2;
+        float4 p[3][2] = {{x0, y0}, {x1, y1}, {pts[2].fX, pts[2].fY}};
+        for (int c = 0; c < 2; ++c) {
+            pa[c] = p[2][c] - (p[1][c] + p[1][c]) + p[0][c];
+            pb[c] = (p[1][c] - p[0][c]) + (p[1][c] - p[0][c]);
+            pc[c] = p[0][c];
+            tb[c] = p[1][c] - p[0][c];
+            ta[c] = p[2][c] - p[1][c] - tb[c];
+        }
+    } else {
+        degree = 3;
+        float4 p[4][2] = {{x0, y0}, {x1, y1}, {pts[2].fX, pts[2].fY}, {pts[3].fX, pts[3].fY}};
+        for (int c = 0; c < 2; ++c) {
+            float4 a = p[3][c] + 3 * (p[1][c] - p[2][c]) - p[0][c];
+            float4 b = p[2][c] - (p[1][c] + p[1][c]) + p[0][c];
+            pa[c] = a;
+            pb[c] = 3 * b;
+            pc[c] = 3 * (p[1][c] - p[0][c]);
+            pd[c] = p[0][c];
+            ta[c] = a;
+            tb[c] = b + b;
+            tc[c] = p[1][c] - p[0][c];
+        }
+    }
+
+    for (int i = 0; i < count; i += 4) {
+        int n = std::min(4, count - i);
+        SkScalar lanes[4];
+        for (int k = 0; k < 4; ++k) {
+            lanes[k] = t[i + std::min(k, n - 1)];
+        }
+        float4 tt = float4::Load(lanes);
+        float4 px, py, tx, ty;
+        switch (degree) {
+            case 1:
+                px = x0 + (x1 - x0) * tt;
+                py = y0 + (y1 - y0) * tt;
+                tx = lineTan.fX;
+                ty = lineTan.fY;
+                break;
+            case 2:
+                px = (pa[0] * tt + pb[0]) * tt + pc[0];
+                py = (pa[1] * tt + pb[1]) * tt + pc[1];
+                tx = ta[0] * tt + tb[0];
+                ty = ta[1] * tt + tb[1];
+                tx = tx + tx;
+                ty = ty + ty;
+                normalize4(&tx, &ty);
+                break;
+            default:
+                px = ((pa[0] * tt + pb[0]) * tt + pc[0]) * tt + pd[0];
+                py = ((pa[1] * tt + pb[1]) * tt + pc[1]) * tt + pd[1];
+                tx = (ta[0] * tt + tb[0]) * tt + tc[0];
+                ty = (ta[1] * tt + tb[1]) * tt + tc[1];
+                normalize4(&tx, &ty);
+                break;
+        }
+        for (int k = 0; k < n; ++k) {
+            if (degree > 1 && (lanes[k] == 0 || lanes[k] == 1)) {
+                compute_pos_tan(pts, segType, lanes[k], pos ? &pos[i + k] : nullptr,
+                                tan ? &tan[i + k] : nullptr);
+                continue;
+            }
+            if (pos) {
+                pos[i + k].set(px[k], py[k]);
+            }
+            if (tan) {
+                tan[i + k].set(tx[k], ty[k]);
+            }
+        }
+    }
+}
+
+bool SkContourMeasure::getPosTan(const SkScalar distances[], int count, SkPoint pos[],
+                                 SkVector tan[]) const {
+    // Samples are handled in batches: first each one is matched to its segment and t, then the
+    // runs of samples that share a curve are evaluated together and scattered to pos and tan.
+    constexpr int kBatch = 64;
+    SkScalar t[kBatch];
+    int sample[kBatch];
+    const SkPoint* curvePts[kBatch];
+    unsigned segType[kBatch];
+    SkPoint batchPos[kBatch];
+    SkVector batchTan[kBatch];
+    const SkScalar length = this->length();
+    bool allComputed = true;
+    int cursor = 0;
+    SkScalar prevDistance = 0;
+    for (int start = 0; start < count; start += kBatch) {
+        int end = std::min(start + kBatch, count);
+        int n = 0;
+        for (int i = start; i < end; ++i) {
+            SkScalar distance = distances[i];
+            if (SkScalarIsNaN(distance)) {
+                allComputed = false;
+                continue;
+            }
+            distance = SkTPin(distance, 0.0f, length);
+            if (distance < prevDistance) {
+                // Unsorted input: a plain binary search beats galloping from the start.
+                cursor = this->lowerBound(0, this->segmentCount(), distance);
+            } else {
+                cursor = this->forwardSearch(cursor, distance);
+            }
+            prevDistance = distance;
+            this->segmentToT(cursor, distance, &t[n]);
+            if (SkScalarIsNaN(t[n])) {
+                allComputed = false;
+                continue;
+            }
+            sample[n] = i;
+            curvePts[n] = this->segmentPts(cursor);
+            segType[n] = this->segmentType(cursor);
+            ++n;
+        }
+        for (int i = 0; i < n;) {
+            int runEnd = i + 1;
+            while (runEnd < n && curvePts[runEnd] == curvePts[i]) {
+                ++runEnd;
+            }
+            compute_pos_tans(curvePts[i], segType[i], t + i, runEnd - i,
+                             pos ? batchPos + i : nullptr, tan ? batchTan + i : nullptr);
+            i = runEnd;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (pos) {
+                pos[sample[i]] = batchPos[i];
+            }
+            if (tan) {
+                tan[sample[i]] = batchTan[i];
+            }
+        }
+    }
+    return allComputed;
+}
+
+// Finds the point on one curve nearest to a query point. The curve is kept in power form as a
+// homogeneous cubic (x, y, w), which covers lines, quads and cubics (w = 1) as well as conics.
+class CurveNearest {
+public:
+    CurveNearest(const SkPoint pts[], unsigned segType) {
+        SkScalar w = 1;
+        SkPoint p[4];
+        int degree = 3;
+        switch (segType) {
+            case kLine_SegType:
+                degree = 1;
+                p[0] = pts[0];
+                p[1] = pts[1];
+                break;
+            case kQuad_SegType:
+                degree = 2;
+                p[0] = pts[0];
+                p[1] = pts[1];
+                p[2] = pts[2];
+                break;
+            case kConic_SegType:
+                degree = 2;
+                w = pts[1].fX;
+                p[0] = pts[0];
+                p[1] = pts[2] * w;
+                p[2] = pts[3];
+                break;
+            default:
+                p[0] = pts[0];
+                p[1] = pts[1];
+                p[2] = pts[2];
+                p[3] = pts[3];
+                break;
+        }
+        SkScalar x[4] = {p[0].fX, p[1].fX, p[2].fX, p[3].fX};
+        SkScalar y[4] = {p[0].fY, p[1].fY, p[2].fY, p[3].fY};
+        SkScalar h[4] = {1, w, 1, 1};
+        to_power(x, degree, fX);
+        to_power(y, degree, fY);
+        to_power(h, degree, fW);
+    }
+
+    // Returns the squared distance from p to the curve and sets t to where it is reached.
+    SkScalar nearest(const SkPoint& p, SkScalar* t) const {
+        // The distance has a local minimum wherever f(t) = (B(t) - p).B'(t) crosses zero upwards.
+        // Those crossings are bracketed by sampling f, then solved by safeguarded Newton steps;
+        // the ends of the curve are candidates too.
+        constexpr int kSamples = 16;
+        SkScalar bestT = 0;
+        SkScalar bestD2 = SkPointPriv::DistanceToSqd(this->eval(0), p);
+        SkScalar endD2 = SkPointPriv::DistanceToSqd(this->eval(1), p);
+        if (endD2 < bestD2) {
+            bestD2 = endD2;
+            bestT = 1;
+        }
+        SkScalar prevT = 0, prevF = this->distanceSlope(p, 0, nullptr);
+        for (int i = 1; i <= kSamples; ++i) {
+            SkScalar sampleT = i * (PK_Scalar1 / kSamples);
+            SkScalar f = this->distanceSlope(p, sampleT, nullptr);
+            if (prevF < 0 && f > 0) {
+                SkScalar rootT = this->solve(p, prevT, sampleT);
+                SkScalar rootD2 = SkPointPriv::DistanceToSqd(this->eval(rootT), p);
+                if (rootD2 < bestD2) {
+                    bestD2 = rootD2;
+                    bestT = rootT;
+                }
+            }
+            prevT = sampleT;
+            prevF = f;
+        }
+        *t = bestT;
+        return bestD2;
+    }
+
+private:
+    // Converts Bernstein coefficients to power form, lowest power first.
+    static void to_power(const SkScalar b[4], int degree, SkScalar c[4]) {
+        c[2] = c[3] = 0;
+        switch (degree) {
+            case 1:
+                c[0] = b[0];
+                c[1] = b[1] - b[0];
+                break;
+            case 2:
+                c[0] = b[0];
+                c[1] = 2 * (b[1] - b[0]);
+                c[2] = b[2] - 2 * b[1] + b[0];
+                break;
+            default:
+                c[0] = b[0];
+                c[1] = 3 * (b[1] - b[0]);
+                c[2] = 3 * (b[2] - 2 * b[1] + b[0]);
+                c[3] = b[3] - 3 * b[2] + 3 * b[1] - b[0];
+                break;
+        }
+    }
+
+    // Sets v, d1 and d2 to the polynomial c and its first two derivatives at t.
+    static void eval_poly(const SkScalar c[4], SkScalar t, SkScalar* v, SkScalar* d1,
+                          SkScalar* d2) {
+        *v = ((c[3] * t + c[2]) * t + c[1]) * t + c[0];
+        *d1 = (3 * c[3] * t + 2 * c[2]) * t + c[1];
+        *d2 = 6 * c[3] * t + 2 * c[2];
+    }
+
+    SkPoint eval(SkScalar t) const {
+        SkScalar w = (fW[2] * t + fW[1]) * t + fW[0];
+        return {(((fX[3] * t + fX[2]) * t + fX[1]) * t + fX[0]) / w,
+                (((fY[3] * t + fY[2]) * t + fY[1]) * t + fY[0]) / w};
+    }
+
+    // Returns f(t) = (B(t) - p).B'(t), and its derivative in df if that is not null.
+    SkScalar distanceSlope(const SkPoint& p, SkScalar t, SkScalar* df) const {
+        SkScalar nx, nx1, nx2, ny, ny1, ny2, w, w1, w2;
+        eval_poly(fX, t, &nx, &nx1, &nx2);
+        eval_poly(fY, t, &ny, &ny1, &ny2);
+        eval_poly(fW, t, &w, &w1, &w2);
+        // B = N / w, B' = (N' - w' B) / w, B'' = (N'' - w'' B - 2 w' B') / w
+        SkScalar invW = 1 / w;
+        SkPoint b = {nx * invW, ny * invW};
+        SkVector b1 = {(nx1 - w1 * b.fX) * invW, (ny1 - w1 * b.fY) * invW};
+        SkVector toCurve = b - p;
+        if (df) {
+            SkVector b2 = {(nx2 - w2 * b.fX - 2 * w1 * b1.fX) * invW,
+                           (ny2 - w2 * b.fY - 2 * w1 * b1.fY) * invW};
+            *df = b1.dot(b1) + toCurve.dot(b2);
+        }
+        return toCurve.dot(b1);
+    }
+
+    // Finds the zero of f in [lo, hi], given f(lo) < 0 < f(hi). Newton steps that leave the
+    // bracket fall back to bisection.
+    SkScalar solve(const SkPoint& p, SkScalar lo, SkScalar hi) const {
+        constexpr int kMaxIterations = 16;
+        SkScalar t = (lo + hi) * 0.5f;
+        for (int i = 0; i < kMaxIterations; ++i) {
+            SkScalar df;
+            SkScalar f = this->distanceSlope(p, t, &df);
+            if (f < 0) {
+                lo = t;
+            } else {
+                hi = t;
+            }
+            SkScalar next = t - f / df;
+            if (!(next > lo && next < hi)) {
+                next = (lo + hi) * 0.5f;
+            }
+            if (PkScalarAbs(next - t) < PK_Scalar1 / (1 << 20)) {
+                return next;
+            }
+            t = next;
+        }
+        return t;
+    }
+
+    SkScalar fX[4], fY[4], fW[4];
+};
+
+static SkScalar distance_to_rect_sqd(const SkRect& r, const SkPoint& p) {
+    SkScalar dx = std::max({r.fLeft - p.fX, 0.0f, p.fX - r.fRight});
+    SkScalar dy = std::max({r.fTop - p.fY, 0.0f, p.fY - r.fBottom});
+    return dx * dx + dy * dy;
+}
+
+const SkContourMeasure::CurveTree& SkContourMeasure::curveTree() const {
+    fCurveTreeOnce([this] {
+        auto tree = std::make_unique<CurveTree>();
+        SkTDArray<CurveTree::Item> items;
+        int count = this->segmentCount();
+        for (int i = 0; i < count; ++i) {
+            if (i > 0 && this->segmentPtIndex(i) == this->segmentPtIndex(i - 1)) {
+                continue;
+            }
+            // A curve lies within its control points; a conic's weight is not one of them.
+            const SkPoint* pts = this->segmentPts(i);
+            CurveTree::Item* item = items.append();
+            item->fCurve = i;
+            switch (this->segmentType(i)) {
+                case kLine_SegType:  item->fBounds.setBounds(pts, 2); break;
+                case kQuad_SegType:  item->fBounds.setBounds(pts, 3); break;
+                case kCubic_SegType: item->fBounds.setBounds(pts, 4); break;
+                case kConic_SegType: {
+                    const SkPoint hull[] = {pts[0], pts[2], pts[3]};
+                    item->fBounds.setBounds(hull, 3);
+                } break;
+            }
+        }
+        if (items.count() > 0) {
+            tree->fNodes.append();
+            tree->fCurves.setReserve(items.count());
+            tree->build(0, items.begin(), items.count());
+        }
+        fLazyBytes.fetch_add(tree->bytesUsed(), std::memory_order_relaxed);
+        fCurveTree = std::move(tree);
+    });
+    return *fCurveTree;
+}
+
+// Returns the distance along the contour of the point at t on the curve whose first segment is
+// curve, interpolating the same way segmentToT() does in reverse.
+SkScalar SkContourMeasure::curveDistance(int curve, SkScalar t) const {
+    if (fLazyChords && this->segmentType(curve) != kLine_SegType) {
+        const SkTDArray<Segment>& chords = this->lazyChords(curve);
+        int chord = 0;
+        while (chord < chords.count() - 1 && chords[chord].getScalarT() < t) {
+            ++chord;
+        }
+        SkScalar startT = 0, startD = curve > 0 ? this->segmentDistance(curve - 1) : 0;
+        if (chord > 0) {
+            startT = chords[chord - 1].getScalarT();
+            startD = chords[chord - 1].fDistance;
+        }
+        SkScalar stopT = chords[chord].getScalarT();
+        return stopT > startT
+                ? startD + (chords[chord].fDistance - startD) * (t - startT) / (stopT - startT)
+                : chords[chord].fDistance;
+    }
+
+    int index = curve;
+    unsigned ptIndex = this->segmentPtIndex(curve);
+    while (index + 1 < this->segmentCount() && this->segmentPtIndex(index + 1) == ptIndex &&
+           this->segmentT(index) < t) {
+        ++index;
+    }
+    SkScalar startT = index > curve ? this->segmentT(index - 1) : 0;
+    SkScalar startD = index > 0 ? this->segmentDistance(index - 1) : 0;
+    SkScalar stopT = this->segmentT(index), stopD = this->segmentDistance(index);
+    if (fArcLength) {
+        return std::min(startD + CurveSpeed(this->segmentPts(index), this->segmentType(index))
+                                         .length(startT, t),
+                        stopD);
+    }
+    return stopT > startT ? startD + (stopD - startD) * (t - startT) / (stopT - startT) : stopD;
+}
+
+bool SkContourMeasure::closestPoint(const SkPoint& point, SkScalar maxDistance, int* hint,
+                                    SkPoint* closest, SkScalar* distance,
+                                    SkVector* tangent) const {
+    if (!this->segmentCount() || !point.isFinite() || !(maxDistance >= 0)) {
+        return false;
+    }
+    const CurveTree& tree = this->curveTree();
+    SkScalar bestD2 = maxDistance * maxDistance, bestT = 0;
+    int bestCurve = -1;
+    auto visit = [&](int curve) {
+        SkScalar t;
+        SkScalar d2 = CurveNearest(this->segmentPts(curve), this->segmentType(curve))
+                              .nearest(point, &t);
+        if (d2 < bestD2 || (bestCurve < 0 && d2 <= bestD2)) {
+            bestD2 = d2;
+            bestT = t;
+            bestCurve = curve;
+        }
+    };
+    // A nearby query's curve usually bounds the search tightly straight away.
+    if (*hint >= 0) {
+        visit(*hint);
+    }
+    // The tree is split at medians, so it is no deeper than about log2 of the curve count.
+    int stack[64];
+    int depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0) {
+        const CurveTree::Node& node = tree.fNodes[stack[--depth]];
+        if (distance_to_rect_sqd(node.fBounds, point) > bestD2) {
+            continue;
+        }
+        if (node.fCount > 0) {
+            for (int i = 0; i < node.fCount; ++i) {
+                const CurveTree::Item& item = tree.fCurves[node.fFirst + i];
+                if (distance_to_rect_sqd(item.fBounds, point) <= bestD2) {
+                    visit(item.fCurve);
+                }
+            }
+            continue;
+        }
+        // Push the farther child first, so the nearer one is searched first.
+        int nearChild = node.fFirst, farChild = node.fFirst + 1;
+        if (distance_to_rect_sqd(tree.fNodes[farChild].fBounds, point) <
+            distance_to_rect_sqd(tree.fNodes[nearChild].fBounds, point)) {
+            std::swap(nearChild, farChild);
+        }
+        PkASSERT(depth + 2 <= static_cast<int>(std::size(stack)));
+        stack[depth++] = farChild;
+        stack[depth++] = nearChild;
+    }
+    if (bestCurve < 0) {
+        return false;
+    }
+    *hint = bestCurve;
+    compute_pos_tan(this->segmentPts(bestCurve), this->segmentType(bestCurve), bestT, closest,
+                    tangent);
+    if (distance) {
+        *distance = this->curveDistance(bestCurve, bestT);
+    }
     return true;
 }
 
+bool SkContourMeasure::getClosestPoint(const SkPoint& point, SkPoint* closest,
+                                       SkScalar* distance, SkVector* tangent,
+                                       SkScalar maxDistance) const {
+    int hint = -1;
+    return this->closestPoint(point, maxDistance, &hint, closest, distance, tangent);
+}
+
+bool SkContourMeasure::getClosestPoints(const SkPoint points[], int count, SkPoint closest[],
+                                        SkScalar distances[], SkVector tangents[],
+                                        SkScalar maxDistance) const {
+    bool allFound = true;
+    int hint = -1;
+    for (int i = 0; i < count; ++i) {
+        allFound &= this->closestPoint(points[i], maxDistance, &hint,
+                                       closest ? &closest[i] : nullptr,
+                                       distances ? &distances[i] : nullptr,
+                                       tangents ? &tangents[i] : nullptr);
+    }
+    return allFound;
+}
+
 bool SkContourMeasure::getMatrix(SkScalar distance, SkMatrix* matrix, MatrixFlags flags) const {
     SkPoint     position;
     SkVector    tangent;
@@ -562,8 +1707,9 @@ bool SkContourMeasure::getMatrix(SkScalar distance, SkMatrix* matrix, MatrixFlag
     return false;
 }
 
-bool SkContourMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
-                                  bool startWithMoveTo) const {
+template <typename Dst>
+bool SkContourMeasure::segmentTo(SkScalar startD, SkScalar stopD, Dst* dst,
+                                 bool startWithMoveTo) const {
     SkScalar length = this->length();    // ensure we have built our segments
 
     if (startD < 0) {
@@ -575,36 +1721,125 @@ bool SkContourMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
     if (!(startD <= stopD)) {   // catch NaN values as well
         return false;
     }
-    if (!fSegments.count()) {
+    if (!this->segmentCount()) {
         return false;
     }
 
-    SkPoint  p;
     SkScalar startT, stopT;
-    const Segment* seg = this->distanceToSegment(startD, &startT);
+    int seg = this->distanceToSegment(startD, &startT);
     if (!SkScalarIsFinite(startT)) {
         return false;
     }
-    const Segment* stopSeg = this->distanceToSegment(stopD, &stopT);
+    int stopSeg = this->distanceToSegment(stopD, &stopT);
     if (!SkScalarIsFinite(stopT)) {
         return false;
     }
+    this->appendSegment(seg, startT, stopSeg, stopT, dst, startWithMoveTo);
+    return true;
+}
+
+template <typename Dst>
+void SkContourMeasure::appendSegment(int seg, SkScalar startT, int stopSeg, SkScalar stopT,
+                                     Dst* dst, bool startWithMoveTo) const {
     if (startWithMoveTo) {
-        compute_pos_tan(&fPts[seg->fPtIndex], seg->fType, startT, &p, nullptr);
+        SkPoint p;
+        compute_pos_tan(this->segmentPts(seg), this->segmentType(seg), startT, &p, nullptr);
         dst->moveTo(p);
     }
 
-    if (seg->fPtIndex == stopSeg->fPtIndex) {
-        SkContourMeasure_segTo(&fPts[seg->fPtIndex], seg->fType, startT, stopT, dst);
+    if (this->segmentPtIndex(seg) == this->segmentPtIndex(stopSeg)) {
+        seg_to(this->segmentPts(seg), this->segmentType(seg), startT, stopT, dst);
     } else {
         do {
-            SkContourMeasure_segTo(&fPts[seg->fPtIndex], seg->fType, startT, PK_Scalar1, dst);
-            seg = SkContourMeasure::Segment::Next(seg);
+            seg_to(this->segmentPts(seg), this->segmentType(seg), startT, PK_Scalar1, dst);
+            seg = this->nextCurve(seg);
             startT = 0;
-        } while (seg->fPtIndex < stopSeg->fPtIndex);
-        SkContourMeasure_segTo(&fPts[seg->fPtIndex], seg->fType, 0, stopT, dst);
+        } while (this->segmentPtIndex(seg) < this->segmentPtIndex(stopSeg));
+        seg_to(this->segmentPts(seg), this->segmentType(seg), 0, stopT, dst);
     }
+}
 
-    return true;
+static void reserve_points(SkPath* dst, int count) {
+    dst->incReserve(count);
+}
+
+static void reserve_points(SkSegmentSink*, int) {}
+
+template <typename Dst>
+bool SkContourMeasure::segmentsTo(const SkScalar startStops[], int count, Dst* dst) const {
+    // Like getPosTan() for many distances: the ranges are located in batches, galloping forward
+    // from the previous range, then dst is grown once for the batch and the pieces appended.
+    constexpr int kBatch = 32;
+    struct Range {
+        int      fStartSeg, fStopSeg;
+        SkScalar fStartT, fStopT;
+    } ranges[kBatch];
+    const SkScalar length = this->length();
+    if (!this->segmentCount()) {
+        return count == 0;
+    }
+    bool allAppended = true;
+    int cursor = 0;
+    SkScalar prevDistance = 0;
+    auto locate = [&](SkScalar distance, SkScalar* t) {
+        if (distance < prevDistance) {
+            cursor = this->lowerBound(0, this->segmentCount(), distance);
+        } else {
+            cursor = this->forwardSearch(cursor, distance);
+        }
+        prevDistance = distance;
+        this->segmentToT(cursor, distance, t);
+        return cursor;
+    };
+    for (int start = 0; start < count; start += kBatch) {
+        int end = std::min(start + kBatch, count);
+        int n = 0;
+        int reservePts = 0;
+        for (int i = start; i < end; ++i) {
+            SkScalar startD = std::max(startStops[2 * i], 0.0f);
+            SkScalar stopD = std::min(startStops[2 * i + 1], length);
+            if (!(startD <= stopD)) {   // catch NaN values as well
+                allAppended = false;
+                continue;
+            }
+            Range& range = ranges[n];
+            range.fStartSeg = locate(startD, &range.fStartT);
+            range.fStopSeg = locate(stopD, &range.fStopT);
+            if (!SkScalarIsFinite(range.fStartT) || !SkScalarIsFinite(range.fStopT)) {
+                allAppended = false;
+                continue;
+            }
+            // A moveTo, every curve point in between, and at most a cubic's worth at the end.
+            reservePts += 4 + this->segmentPtIndex(range.fStopSeg) -
+                          this->segmentPtIndex(range.fStartSeg);
+            ++n;
+        }
+        reserve_points(dst, reservePts);
+        for (int i = 0; i < n; ++i) {
+            this->appendSegment(ranges[i].fStartSeg, ranges[i].fStartT, ranges[i].fStopSeg,
+                                ranges[i].fStopT, dst, true);
+        }
+    }
+    return allAppended;
+}
+
+bool SkContourMeasure::getSegment(SkScalar startD, SkScalar stopD, SkPath* dst,
+                                  bool startWithMoveTo) const {
+    return this->segmentTo(startD, stopD, dst, startWithMoveTo);
+}
+
+bool SkContourMeasure::getSegments(const SkScalar startStops[], int count, SkPath* dst) const {
+    return this->segmentsTo(startStops, count, dst);
+}
+
+bool SkContourMeasurePriv::GetSegment(const SkContourMeasure& measure, SkScalar startD,
+                                      SkScalar stopD, SkSegmentSink* dst, bool startWithMoveTo) {
+    return measure.segmentTo(startD, stopD, dst, startWithMoveTo);
+}
+
+bool SkContourMeasurePriv::GetSegments(const SkContourMeasure& measure,
+                                       const SkScalar startStops[], int count,
+                                       SkSegmentSink* dst) {
+    return measure.segmentsTo(startStops, count, dst);
 }
 }  // namespace pk
\ No newline at end of file
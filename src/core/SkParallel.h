@@ -0,0 +1,45 @@
+/*
+ * Copyright 2021 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace pk {
+/**
+ *  Returns maxThreads, or the number of hardware threads if maxThreads is not positive.
+ */
+inline int SkResolveThreadCount(int maxThreads) {
+    return maxThreads > 0 ? maxThreads
+                          : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+/**
+ *  Calls fn(i) for each i in [0, count), handing the indices out in increasing order to up to
+ *  threads threads, the calling one included. Returns once every call has returned.
+ */
+template <typename Fn>
+void SkParallelFor(int count, int threads, const Fn& fn) {
+    std::atomic<int> next{0};
+    auto work = [&]() {
+        for (int i; (i = next.fetch_add(1)) < count;) {
+            fn(i);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int i = 1; i < std::min(count, threads); ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+}  // namespace pk
@@ -10,8 +10,10 @@
 #include <utility>
 #include "include/core/SkMath.h"
 #include "include/core/SkRRect.h"
+#include "include/pathops/SkPathOps.h"
 #include "include/private/SkPathRef.h"
 #include "include/private/SkTo.h"
+#include "include/private/SkVx.h"
 #include "src/core/SkCubicClipper.h"
 #include "src/core/SkGeometry.h"
 #include "src/core/SkMatrixPriv.h"
@@ -21,6 +23,7 @@
 #include "src/core/SkTLazy.h"
 #include "src/pathops/SkPathOpsPoint.h"
 #include "src/gpu/geometry/GrAATriangulator.h"
+#include "src/gpu/geometry/GrPathUtils.h"
 
 namespace pk {
 static float poly_eval(float A, float B, float C, float t) {
@@ -1282,6 +1285,121 @@ SkPath::Verb SkPath::Iter::next(SkPoint ptsParam[4]) {
   return (Verb)verb;
 }
 
+SkPath::BatchIter::BatchIter(const SkPath& path, bool forceClose)
+    : fPts(path.fPathRef->points())
+    , fVerbs(path.fPathRef->verbsBegin())
+    , fVerbStop(path.fPathRef->verbsEnd())
+    , fConicWeights(path.fPathRef->conicWeights())
+    , fMoveTo{0, 0}
+    , fLastPt{0, 0}
+    , fForceClose(forceClose)
+    , fInContour(false)
+    , fCloseLine(false) {}
+
+bool SkPath::BatchIter::next(Batch* batch) {
+    // Find where the batch starts, passing over moves and contours without segments. A contour
+    // with segments always has its close consumed by the batch that ends it.
+    while (!fCloseLine) {
+        if (fVerbs == fVerbStop) {
+            return false;
+        }
+        unsigned verb = *fVerbs;
+        if (verb == kMove_Verb) {
+            fMoveTo = fLastPt = *fPts++;
+        } else if (verb != kClose_Verb) {
+            break;
+        }
+        ++fVerbs;
+    }
+
+    const Verb verb = fCloseLine ? kLine_Verb : static_cast<Verb>(*fVerbs);
+    const int ptCount = SkPathPriv::PtsInVerb(verb);
+    // The run is copied through locals, which the stores to the arrays cannot alias.
+    int count = 0;
+    SkPoint lastPt = fLastPt;
+    auto append = [&](const SkPoint pts[]) {
+        fXs[0][count] = lastPt.fX;
+        fYs[0][count] = lastPt.fY;
+        for (int i = 0; i < ptCount; ++i) {
+            fXs[i + 1][count] = pts[i].fX;
+            fYs[i + 1][count] = pts[i].fY;
+        }
+        lastPt = pts[ptCount - 1];
+        ++count;
+    };
+    if (!fCloseLine) {
+        const SkPoint* pts = fPts;
+        const uint8_t* verbs = fVerbs;
+        const uint8_t* runStop = verbs + std::min<ptrdiff_t>(fVerbStop - verbs, kMaxSegments);
+        do {
+            append(pts);
+            pts += ptCount;
+        } while (++verbs < runStop && *verbs == verb);
+        if (verb == kConic_Verb) {
+            memcpy(fWs, fConicWeights, count * sizeof(SkScalar));
+            fConicWeights += count;
+        }
+        fPts = pts;
+        fVerbs = verbs;
+    }
+    fLastPt = lastPt;
+
+    // At the end of the contour, add the closing line to a batch of lines if it fits, and
+    // otherwise leave it to start the next batch.
+    batch->fContourStart = !fInContour;
+    batch->fContourEnd = false;
+    batch->fClosed = false;
+    fInContour = true;
+    fCloseLine = false;
+    if (fVerbs == fVerbStop || *fVerbs == kMove_Verb || *fVerbs == kClose_Verb) {
+        bool isClosed = fForceClose || (fVerbs != fVerbStop && *fVerbs == kClose_Verb);
+        // Like Iter::autoClose(), no closing line if either end is NaN.
+        bool needsLine = isClosed && fLastPt != fMoveTo &&
+                         !SkScalarIsNaN(fLastPt.fX) && !SkScalarIsNaN(fLastPt.fY) &&
+                         !SkScalarIsNaN(fMoveTo.fX) && !SkScalarIsNaN(fMoveTo.fY);
+        if (needsLine && (verb != kLine_Verb || count == kMaxSegments)) {
+            fCloseLine = true;
+        } else {
+            if (needsLine) {
+                append(&fMoveTo);
+                fLastPt = fMoveTo;
+            }
+            batch->fContourEnd = true;
+            batch->fClosed = isClosed;
+            fInContour = false;
+            if (fVerbs != fVerbStop && *fVerbs == kClose_Verb) {
+                ++fVerbs;
+            }
+        }
+    }
+
+    // Repeat the last segment out to a whole number of lanes.
+    // Stored as two 4-wide halves; 8-wide vectors would change the ABI on non-AVX builds.
+    using Half = skvx::Vec<kLanes / 2, float>;
+    auto pad = [](SkScalar* values, int count) {
+        Half last(values[count - 1]);
+        last.store(values + count);
+        last.store(values + count + kLanes / 2);
+    };
+    for (int i = 0; i <= ptCount; ++i) {
+        pad(fXs[i], count);
+        pad(fYs[i], count);
+        batch->fX[i] = fXs[i];
+        batch->fY[i] = fYs[i];
+    }
+    for (int i = ptCount + 1; i < 4; ++i) {
+        batch->fX[i] = batch->fY[i] = nullptr;
+    }
+    batch->fWeights = nullptr;
+    if (verb == kConic_Verb) {
+        pad(fWs, count);
+        batch->fWeights = fWs;
+    }
+    batch->fVerb = verb;
+    batch->fCount = count;
+    return true;
+}
+
 void SkPath::RawIter::setPath(const SkPath& path) {
   SkPathPriv::Iterate iterate(path);
   fIter = iterate.begin();
@@ -2507,6 +2625,329 @@ bool SkPath::hasMultipleContours() const {
   return false;
 }
 
+void SkPath::flatten(SkScalar tolerance, const SkMatrix& matrix, FlattenSink* sink) const {
+    PkASSERT(sink);
+    if (matrix.hasPerspective()) {
+        SkPath devPath;
+        this->transform(matrix, &devPath);
+        devPath.flatten(tolerance, SkMatrix::I(), sink);
+        return;
+    }
+
+    // The polyline buffer is reused for every contour, so a path allocates at most once.
+    SkTDArray<SkPoint> polyline;
+    polyline.setReserve(this->countPoints());
+    bool hasSegment = false;
+    auto flush = [&](bool isClosed) {
+        if (hasSegment) {
+            sink->polyline(polyline.begin(), polyline.count(), isClosed);
+        }
+        polyline.rewind();
+        hasSegment = false;
+    };
+
+    SkPoint devPts[4];
+    for (auto [verb, pts, w] : SkPathPriv::Iterate(*this)) {
+        switch (verb) {
+            case SkPathVerb::kMove:
+                flush(false);
+                matrix.mapPoints(polyline.append(), pts, 1);
+                break;
+            case SkPathVerb::kLine:
+                matrix.mapPoints(polyline.append(), pts + 1, 1);
+                hasSegment = true;
+                break;
+            case SkPathVerb::kQuad: {
+                matrix.mapPoints(devPts, pts, 3);
+                int n = GrPathUtils::quadraticSegmentCount(devPts, tolerance);
+                GrPathUtils::flattenQuadratic(devPts, n, polyline.append(n));
+                hasSegment = true;
+                break;
+            }
+            case SkPathVerb::kConic: {
+                matrix.mapPoints(devPts, pts, 3);
+                int n = GrPathUtils::conicSegmentCount(devPts, *w, tolerance);
+                GrPathUtils::flattenConic(devPts, *w, n, polyline.append(n));
+                hasSegment = true;
+                break;
+            }
+            case SkPathVerb::kCubic: {
+                matrix.mapPoints(devPts, pts, 4);
+                int n = GrPathUtils::cubicSegmentCount(devPts, tolerance);
+                GrPathUtils::flattenCubic(devPts, n, polyline.append(n));
+                hasSegment = true;
+                break;
+            }
+            case SkPathVerb::kClose:
+                flush(true);
+                break;
+        }
+    }
+    flush(false);
+}
+
+namespace {
+// Twice the signed area of a contour and three times its first moments, from Green's theorem:
+// 2A = integral of (x dy - y dx), and 3 * integral of x dA = integral of x (x dy - y dx).
+// Points are taken relative to a common origin to keep the products small.
+struct AreaSums {
+    double fArea2 = 0;
+    double fMomentX3 = 0;
+    double fMomentY3 = 0;
+
+    void addLine(const SkPoint& p0, const SkPoint& p1) {
+        // x dy - y dx is constant along a line.
+        double cross = (double)p0.fX * p1.fY - (double)p0.fY * p1.fX;
+        fArea2 += cross;
+        fMomentX3 += cross * ((double)p0.fX + p1.fX) * 0.5;
+        fMomentY3 += cross * ((double)p0.fY + p1.fY) * 0.5;
+    }
+
+    // The integrands are polynomials of degree at most 7 for a cubic (4 for a quad), which four
+    // point Gauss-Legendre quadrature integrates exactly. The four nodes are evaluated together.
+    void addCubic(const SkPoint pts[4]) {
+        const SkCubicCoeff coeff(pts);
+        this->addPolynomial(coeff.fA, coeff.fB, coeff.fC, coeff.fD);
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        const SkQuadCoeff coeff(pts);
+        this->addPolynomial(Sk2s(0), coeff.fA, coeff.fB, coeff.fC);
+    }
+
+    // A conic adds its chord plus the segment between the chord and the arc. In the frame where
+    // the conic is an arc of the unit circle, [cos t, -sin t] to [cos t, sin t] with w = cos t,
+    // that segment has area t - sin t cos t and centroid at (2/3) sin^3 t / area on the axis;
+    // both carry over to any conic as fractions of its control triangle, which is affine
+    // invariant. Conics with w > 1 (hyperbolas) take the same formulas with t imaginary.
+    void addConic(const SkPoint pts[3], SkScalar weight) {
+        this->addLine(pts[0], pts[2]);
+        double w = weight;
+        double triangleArea = 0.5 * ((double)(pts[1].fX - pts[0].fX) * (pts[2].fY - pts[0].fY) -
+                                     (double)(pts[1].fY - pts[0].fY) * (pts[2].fX - pts[0].fX));
+        // The segment's area as a fraction of the triangle's, and how far its centroid lies from
+        // the chord's midpoint toward pts[1], as a fraction of that distance.
+        double areaRatio, centroidRatio;
+        double w2 = w * w;
+        if (std::abs(w - 1) < 1e-6) {
+            areaRatio = 2.0 / 3;  // parabola
+            centroidRatio = 1.0 / 5;
+        } else if (w < 1) {
+            double t = std::acos(w), s = std::sqrt(1 - w2);
+            double segment = t - s * w;
+            double centroid = (2.0 / 3) * s * s * s / segment;
+            areaRatio = segment * w / (s * s * s);
+            centroidRatio = (centroid - w) * w / (s * s);
+        } else {
+            double t = std::acosh(w), s = std::sqrt(w2 - 1);
+            double segment = s * w - t;
+            double centroid = (2.0 / 3) * s * s * s / segment;
+            areaRatio = segment * w / (s * s * s);
+            centroidRatio = (w - centroid) * w / (s * s);
+        }
+        double area = areaRatio * triangleArea;
+        double midX = 0.5 * ((double)pts[0].fX + pts[2].fX);
+        double midY = 0.5 * ((double)pts[0].fY + pts[2].fY);
+        fArea2 += 2 * area;
+        fMomentX3 += 3 * area * (midX + centroidRatio * (pts[1].fX - midX));
+        fMomentY3 += 3 * area * (midY + centroidRatio * (pts[1].fY - midY));
+    }
+
+    void add(const AreaSums& sums) {
+        fArea2 += sums.fArea2;
+        fMomentX3 += sums.fMomentX3;
+        fMomentY3 += sums.fMomentY3;
+    }
+
+    void negate() {
+        fArea2 = -fArea2;
+        fMomentX3 = -fMomentX3;
+        fMomentY3 = -fMomentY3;
+    }
+
+    SkPath::AreaInfo info(const SkPoint& origin) const {
+        SkPath::AreaInfo info;
+        info.fArea = PkDoubleToScalar(fArea2 * 0.5);
+        info.fCentroid = {0, 0};
+        if (fArea2 != 0) {
+            // centroid = (3 * moment) / (3 * area) = moment3 / (1.5 * area2)
+            double scale = 1 / (1.5 * fArea2);
+            info.fCentroid.set(PkDoubleToScalar(fMomentX3 * scale + origin.fX),
+                               PkDoubleToScalar(fMomentY3 * scale + origin.fY));
+        }
+        return info;
+    }
+
+private:
+    // B(t) = a t^3 + b t^2 + c t + d, for t in [0, 1].
+    void addPolynomial(const Sk2s& a, const Sk2s& b, const Sk2s& c, const Sk2s& d) {
+        static constexpr float kNodes[] = {0.0694318442f, 0.3300094782f, 0.6699905218f,
+                                           0.9305681558f};
+        static constexpr float kWeights[] = {0.1739274226f, 0.3260725774f, 0.3260725774f,
+                                             0.1739274226f};
+        const Sk4f t = Sk4f::Load(kNodes);
+        const Sk4f x = ((Sk4f(a[0]) * t + Sk4f(b[0])) * t + Sk4f(c[0])) * t + Sk4f(d[0]);
+        const Sk4f y = ((Sk4f(a[1]) * t + Sk4f(b[1])) * t + Sk4f(c[1])) * t + Sk4f(d[1]);
+        const Sk4f dx = (Sk4f(3 * a[0]) * t + Sk4f(2 * b[0])) * t + Sk4f(c[0]);
+        const Sk4f dy = (Sk4f(3 * a[1]) * t + Sk4f(2 * b[1])) * t + Sk4f(c[1]);
+        const Sk4f cross = (x * dy - y * dx) * Sk4f::Load(kWeights);
+        float area[4], momentX[4], momentY[4];
+        cross.store(area);
+        (cross * x).store(momentX);
+        (cross * y).store(momentY);
+        for (int i = 0; i < 4; ++i) {
+            fArea2 += area[i];
+            fMomentX3 += momentX[i];
+            fMomentY3 += momentY[i];
+        }
+    }
+};
+
+// Appends the sums of each contour of path with at least one segment, taken about origin.
+// If testPts is not null, it also receives a point on each of those contours.
+void contour_area_sums(const SkPath& path, const SkPoint& origin,
+                       SkTDArray<AreaSums>* contours, SkTDArray<SkPoint>* testPts) {
+    AreaSums sums;
+    SkPoint start = {0, 0}, last = {0, 0};
+    bool hasSegment = false;
+    auto flush = [&]() {
+        if (hasSegment) {
+            sums.addLine(last, start);
+            *contours->append() = sums;
+        }
+        sums = AreaSums();
+        hasSegment = false;
+    };
+    SkPoint rel[4];
+    for (auto [verb, pts, w] : SkPathPriv::Iterate(path)) {
+        // Iterate() hands segments their start point too.
+        bool isSegment = verb != SkPathVerb::kMove && verb != SkPathVerb::kClose;
+        int ptCount = SkPathPriv::PtsInVerb(static_cast<unsigned>(verb)) + isSegment;
+        for (int i = 0; i < ptCount; ++i) {
+            rel[i] = pts[i] - origin;
+        }
+        if (isSegment && !hasSegment && testPts) {
+            // The middle of the first segment; Simplify()'s contours may share end points.
+            SkPoint mid;
+            switch (verb) {
+                case SkPathVerb::kLine:  mid = (pts[0] + pts[1]) * 0.5f; break;
+                case SkPathVerb::kQuad:  mid = SkEvalQuadAt(pts, 0.5f); break;
+                case SkPathVerb::kConic: mid = SkConic(pts, *w).evalAt(0.5f); break;
+                default:                 SkEvalCubicAt(pts, 0.5f, &mid, nullptr, nullptr); break;
+            }
+            *testPts->append() = mid;
+        }
+        switch (verb) {
+            case SkPathVerb::kMove:
+                flush();
+                start = last = rel[0];
+                break;
+            case SkPathVerb::kLine:
+                sums.addLine(rel[0], rel[1]);
+                hasSegment = true;
+                last = rel[1];
+                break;
+            case SkPathVerb::kQuad:
+                sums.addQuad(rel);
+                hasSegment = true;
+                last = rel[2];
+                break;
+            case SkPathVerb::kConic:
+                sums.addConic(rel, *w);
+                hasSegment = true;
+                last = rel[2];
+                break;
+            case SkPathVerb::kCubic:
+                sums.addCubic(rel);
+                hasSegment = true;
+                last = rel[3];
+                break;
+            case SkPathVerb::kClose:
+                break;
+        }
+    }
+    flush();
+}
+}  // namespace
+
+bool SkPath::computeArea(AreaInfo* info, AreaMode mode, std::vector<AreaInfo>* contours) const {
+    PkASSERT(info);
+    if (!this->isFinite()) {
+        return false;
+    }
+    SkPath simplified;
+    const SkPath* path = this;
+    if (mode == kFilled_AreaMode) {
+        if (!Simplify(*this, &simplified)) {
+            return false;
+        }
+        path = &simplified;
+    }
+    SkPoint origin = path->countPoints() > 0 ? path->getPoint(0) : SkPoint{0, 0};
+    SkTDArray<AreaSums> sums;
+    SkTDArray<SkPoint> testPts;
+    contour_area_sums(*path, origin, &sums, mode == kFilled_AreaMode ? &testPts : nullptr);
+
+    if (mode == kFilled_AreaMode && sums.count() > 1) {
+        // Simplify() leaves the contours disjoint but wound either way, with even-odd fill. A
+        // contour inside an odd number of others is a hole, and the rest are outlines.
+        std::vector<SkPath> outlines;
+        std::vector<SkRect> bounds;
+        SkPath::Iter iter(*path, false);
+        SkPath outline;
+        SkPoint pts[4];
+        for (SkPath::Verb verb = iter.next(pts);; verb = iter.next(pts)) {
+            if (verb == kDone_Verb || verb == kMove_Verb) {
+                if (outline.countPoints() > 1) {
+                    bounds.push_back(outline.getBounds());
+                    outlines.push_back(std::move(outline));
+                }
+                outline.reset();
+                if (verb == kDone_Verb) {
+                    break;
+                }
+            }
+            switch (verb) {
+                case kMove_Verb:  outline.moveTo(pts[0]); break;
+                case kLine_Verb:  outline.lineTo(pts[1]); break;
+                case kQuad_Verb:  outline.quadTo(pts[1], pts[2]); break;
+                case kConic_Verb: outline.conicTo(pts[1], pts[2], iter.conicWeight()); break;
+                case kCubic_Verb: outline.cubicTo(pts[1], pts[2], pts[3]); break;
+                default:          break;
+            }
+        }
+        PkASSERT(static_cast<int>(outlines.size()) == sums.count());
+        for (int i = 0; i < sums.count(); ++i) {
+            bool isHole = false;
+            for (int j = 0; j < sums.count(); ++j) {
+                if (j != i && bounds[j].contains(testPts[i].fX, testPts[i].fY) &&
+                    outlines[j].contains(testPts[i].fX, testPts[i].fY)) {
+                    isHole = !isHole;
+                }
+            }
+            if ((sums[i].fArea2 < 0) != isHole) {
+                sums[i].negate();
+            }
+        }
+    } else if (mode == kFilled_AreaMode && sums.count() == 1 && sums[0].fArea2 < 0) {
+        sums[0].negate();
+    }
+
+    AreaSums total;
+    if (contours) {
+        contours->clear();
+        contours->reserve(sums.count());
+    }
+    for (const AreaSums& contour : sums) {
+        total.add(contour);
+        if (contours) {
+            contours->push_back(contour.info(origin));
+        }
+    }
+    *info = total.info(origin);
+    return true;
+}
+
 int SkPath::toAATriangles(float tolerance,
                           const SkRect& clipBounds,
                           std::vector<float>* vertex) const {
@@ -2519,4 +2960,224 @@ int SkPath::toTriangles(float tolerance,
                         bool* isLinear) const {
   return GrTriangulator::PathToTriangles(*this, tolerance, clipBounds, vertex, isLinear);
 }
+
+int SkPath::toAATriangles(float tolerance,
+                          const SkRect& clipBounds,
+                          const VertexEncoding& encoding,
+                          std::vector<uint16_t>* vertex) const {
+    std::vector<float> floats;
+    int count = GrAATriangulator::PathToAATriangles(*this, tolerance, clipBounds, &floats);
+    size_t start = vertex->size();
+    vertex->resize(start + floats.size());
+    EncodeVertices(floats.data(), count, true, encoding, vertex->data() + start);
+    return count;
+}
+
+int SkPath::toTriangles(float tolerance,
+                        const SkRect& clipBounds,
+                        const VertexEncoding& encoding,
+                        std::vector<uint16_t>* vertex,
+                        bool* isLinear) const {
+    std::vector<float> floats;
+    int count = GrTriangulator::PathToTriangles(*this, tolerance, clipBounds, &floats, isLinear);
+    size_t start = vertex->size();
+    vertex->resize(start + floats.size());
+    EncodeVertices(floats.data(), count, false, encoding, vertex->data() + start);
+    return count;
+}
+
+void SkPath::EncodeVertices(const float src[],
+                            int count,
+                            bool hasCoverage,
+                            const VertexEncoding& encoding,
+                            uint16_t dst[]) {
+    using float4 = skvx::Vec<4, float>;
+    using uint4 = skvx::Vec<4, uint16_t>;
+    // The vertices are encoded four at a time as lanes x, y[, coverage] chunks of four floats,
+    // so lane i of chunk j holds component (4 * j + i) % lanesPerVertex. The per lane constants
+    // below repeat with that period, which lets every chunk run the same branchless kernel.
+    const int lanesPerVertex = hasCoverage ? 3 : 2;
+    const int lanesPerBlock = 4 * lanesPerVertex;
+    const bool fixed = encoding.fFormat == VertexEncoding::kFixed16_Format;
+    float offset[12], scale[12], lo[12], hi[12];
+    uint16_t isCoverage[12];
+    for (int i = 0; i < lanesPerBlock; ++i) {
+        int component = i % lanesPerVertex;
+        if (component == 2) {
+            offset[i] = 0;
+            scale[i] = 255;
+            lo[i] = 0;
+            hi[i] = 255;
+            isCoverage[i] = 0xFFFF;
+        } else {
+            offset[i] = component == 0 ? -encoding.fOrigin.fX : -encoding.fOrigin.fY;
+            scale[i] = fixed ? encoding.fScale : 1;
+            lo[i] = -32768;
+            hi[i] = 32767;
+            isCoverage[i] = 0;
+        }
+    }
+    auto encodeBlock = [&](const float* in, uint16_t* out) {
+        for (int j = 0; j < lanesPerVertex; ++j) {
+            float4 v = (float4::Load(in + 4 * j) + float4::Load(offset + 4 * j)) *
+                       float4::Load(scale + 4 * j);
+            uint4 rounded = skvx::cast<uint16_t>(skvx::lrint(
+                    skvx::pin(v, float4::Load(lo + 4 * j), float4::Load(hi + 4 * j))));
+            if (!fixed) {
+                rounded = skvx::if_then_else(uint4::Load(isCoverage + 4 * j), rounded,
+                                             skvx::to_half(v));
+            }
+            rounded.store(out + 4 * j);
+        }
+    };
+    int laneCount = count * lanesPerVertex;
+    int i = 0;
+    for (; i + lanesPerBlock <= laneCount; i += lanesPerBlock) {
+        encodeBlock(src + i, dst + i);
+    }
+    if (i < laneCount) {
+        float in[12] = {};
+        uint16_t out[12];
+        memcpy(in, src + i, (laneCount - i) * sizeof(float));
+        encodeBlock(in, out);
+        memcpy(dst + i, out, (laneCount - i) * sizeof(uint16_t));
+    }
+}
+
+SkPath::TriangleCache::TriangleCache(const SkPath& path, float tolerance, SkScalar maxScale)
+        : fPath(path), fTolerance(tolerance), fMaxScale(0), fIsLinear(true) {
+    this->triangulate(SkScalarIsFinite(maxScale) && maxScale > 0 ? maxScale : 1);
+}
+
+void SkPath::TriangleCache::triangulate(SkScalar maxScale) {
+    fMaxScale = maxScale;
+    fVertices.clear();
+    fIsLinear = true;
+    if (fPath.isInverseFillType()) {
+        // The fill covers clipBounds, which is only known in device space.
+        return;
+    }
+    GrTriangulator::PathToTriangles(fPath, fTolerance / maxScale, fPath.getBounds(), &fVertices,
+                                    &fIsLinear);
+}
+
+bool SkPath::TriangleCache::canTransform(const SkMatrix& matrix) const {
+    return !fPath.isInverseFillType() && !matrix.hasPerspective() &&
+           matrix.getMaxScale() <= fMaxScale;
+}
+
+int SkPath::TriangleCache::toTriangles(const SkMatrix& matrix,
+                                       const SkRect& clipBounds,
+                                       std::vector<float>* vertex,
+                                       bool* isLinear) {
+    SkScalar scale = matrix.getMaxScale();
+    if (fPath.isInverseFillType() || matrix.hasPerspective() || !SkScalarIsFinite(scale)) {
+        SkPath devPath;
+        fPath.transform(matrix, &devPath);
+        return devPath.toTriangles(fTolerance, clipBounds, vertex, isLinear);
+    }
+    if (scale > fMaxScale) {
+        this->triangulate(std::max(scale, 2 * fMaxScale));
+    }
+    int count = SkToInt(fVertices.size() / 2);
+    size_t start = vertex->size();
+    vertex->resize(start + fVertices.size());
+    matrix.mapPoints(reinterpret_cast<SkPoint*>(vertex->data() + start),
+                     reinterpret_cast<const SkPoint*>(fVertices.data()), count);
+    *isLinear = fIsLinear;
+    return count;
+}
+
+int SkPath::toAATrianglesInParallel(float tolerance,
+                                    const SkRect& clipBounds,
+                                    std::vector<float>* vertex,
+                                    int maxThreads) const {
+  return GrAATriangulator::PathToAATrianglesInParallel(*this, tolerance, clipBounds, vertex,
+                                                       maxThreads);
+}
+
+int SkPath::toTrianglesInParallel(float tolerance,
+                                  const SkRect& clipBounds,
+                                  std::vector<float>* vertex,
+                                  bool* isLinear,
+                                  int maxThreads) const {
+  return GrTriangulator::PathToTrianglesInParallel(*this, tolerance, clipBounds, vertex, isLinear,
+                                                   maxThreads);
+}
+
+int SkPath::toTiledTriangles(float tolerance,
+                             const SkRect& clipBounds,
+                             float tileWidth,
+                             float tileHeight,
+                             std::vector<float>* vertex,
+                             std::vector<int>* tileOffsets,
+                             bool* isLinear,
+                             int maxThreads) const {
+  return GrTriangulator::PathToTiledTriangles(*this, tolerance, clipBounds, tileWidth, tileHeight,
+                                              vertex, tileOffsets, isLinear, maxThreads);
+}
+
+int SkPath::toAATriangles(float tolerance,
+                          const SkRect& clipBounds,
+                          int maxPoints,
+                          std::vector<float>* vertex,
+                          float* achievedTolerance) const {
+  return GrAATriangulator::PathToAATrianglesWithBudget(*this, tolerance, clipBounds, maxPoints,
+                                                       vertex, achievedTolerance);
+}
+
+int SkPath::toTriangles(float tolerance,
+                        const SkRect& clipBounds,
+                        int maxPoints,
+                        std::vector<float>* vertex,
+                        bool* isLinear,
+                        float* achievedTolerance) const {
+  return GrTriangulator::PathToTrianglesWithBudget(*this, tolerance, clipBounds, maxPoints, vertex,
+                                                   isLinear, achievedTolerance);
+}
+
+int SkPath::toAATriangles(float tolerance,
+                          const SkRect& clipBounds,
+                          VertexAllocator* allocator) const {
+  return GrAATriangulator::PathToAATriangles(*this, tolerance, clipBounds, allocator);
+}
+
+int SkPath::toTriangles(float tolerance,
+                        const SkRect& clipBounds,
+                        VertexAllocator* allocator,
+                        bool* isLinear) const {
+  return GrTriangulator::PathToTriangles(*this, tolerance, clipBounds, allocator, isLinear);
+}
+
+int SkPath::toAATriangles(float tolerance,
+                          const SkRect& clipBounds,
+                          std::vector<float>* vertex,
+                          std::vector<uint16_t>* indices) const {
+  return GrAATriangulator::PathToIndexedAATriangles(*this, tolerance, clipBounds, vertex, indices);
+}
+
+int SkPath::toAATriangles(float tolerance,
+                          const SkRect& clipBounds,
+                          std::vector<float>* vertex,
+                          std::vector<uint32_t>* indices) const {
+  return GrAATriangulator::PathToIndexedAATriangles(*this, tolerance, clipBounds, vertex, indices);
+}
+
+int SkPath::toTriangles(float tolerance,
+                        const SkRect& clipBounds,
+                        std::vector<float>* vertex,
+                        std::vector<uint16_t>* indices,
+                        bool* isLinear) const {
+  return GrTriangulator::PathToIndexedTriangles(
+          *this, tolerance, clipBounds, vertex, indices, isLinear);
+}
+
+int SkPath::toTriangles(float tolerance,
+                        const SkRect& clipBounds,
+                        std::vector<float>* vertex,
+                        std::vector<uint32_t>* indices,
+                        bool* isLinear) const {
+  return GrTriangulator::PathToIndexedTriangles(
+          *this, tolerance, clipBounds, vertex, indices, isLinear);
+}
 }  // namespace pk
\ No newline at end of file
@@ -22,4 +22,36 @@ enum SkSegType {
     kConic_SegType,
 };
 
+class SkContourMeasure;
+
+/** \class SkSegmentSink
+    Receives the verbs produced when extracting part of a contour (see
+    SkContourMeasure::getSegment). SkPath is the usual destination; other consumers, such as the
+    stroker, can take the verbs directly instead of first building an intermediate path.
+*/
+class SkSegmentSink {
+public:
+    virtual ~SkSegmentSink() {}
+
+    /** Returns false if nothing has been added to the sink yet. */
+    virtual bool getLastPt(SkPoint* lastPt) const = 0;
+
+    virtual void moveTo(const SkPoint& pt) = 0;
+    virtual void lineTo(const SkPoint& pt) = 0;
+    virtual void quadTo(const SkPoint& pt1, const SkPoint& pt2) = 0;
+    virtual void conicTo(const SkPoint& pt1, const SkPoint& pt2, SkScalar weight) = 0;
+    virtual void cubicTo(const SkPoint& pt1, const SkPoint& pt2, const SkPoint& pt3) = 0;
+};
+
+class SkContourMeasurePriv {
+public:
+    /** Same as SkContourMeasure::getSegment(), but emits the pieces into an arbitrary sink. */
+    static bool GetSegment(const SkContourMeasure& measure, SkScalar startD, SkScalar stopD,
+                           SkSegmentSink* dst, bool startWithMoveTo);
+
+    /** Same as SkContourMeasure::getSegments(), but emits the pieces into an arbitrary sink. */
+    static bool GetSegments(const SkContourMeasure& measure, const SkScalar startStops[],
+                            int count, SkSegmentSink* dst);
+};
+
 }  // namespace pk
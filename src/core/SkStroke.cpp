@@ -14,6 +14,8 @@
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkPointPriv.h"
 #include "src/core/SkPaintDefaults.h"
+#include "src/core/SkTSort.h"
+#include "include/pathops/SkPathOps.h"
 
 
 
@@ -134,10 +136,10 @@ struct SkQuadConstruct {    // The state of the quad stroke under construction.
 
 class SkPathStroker {
 public:
-    SkPathStroker(const SkPath& src,
+    SkPathStroker(int srcPtCount,
                   SkScalar radius, SkScalar miterLimit, SkPaint::Cap,
                   SkPaint::Join, SkScalar resScale,
-                  bool canIgnoreCenter);
+                  bool canIgnoreCenter, bool resolveInnerJoins = false);
 
     bool hasOnlyMoveTo() const { return 0 == fSegmentCount; }
     SkPoint moveToPt() const { return fFirstPt; }
@@ -161,6 +163,14 @@ public:
                fOuter.isZeroLengthSincePoint(fFirstOuterPtIndexInContour);
     }
 
+    // Mirrors the teeny line test in lineTo(): returns true if whether a line to pt is stroked
+    // depends on a later segment of the contour supplying a tangent.
+    bool lineNeedsLookAhead(const SkPoint& pt) const {
+        return SkStrokerPriv::CapFactory(SkPaint::kButt_Cap) != fCapper && !fJoinCompleted &&
+               SkPointPriv::EqualsWithinTolerance(fPrevPt, pt,
+                                                  PK_ScalarNearlyZero * fInvResScale);
+    }
+
 private:
     SkScalar    fRadius;
     SkScalar    fInvMiterLimit;
@@ -174,7 +184,13 @@ private:
     int         fFirstOuterPtIndexInContour;
     int         fSegmentCount;
     bool        fPrevIsLine;
+    bool        fFirstIsLine;
     bool        fCanIgnoreCenter;
+    bool        fResolveInnerJoins;
+
+    // Point index of the pivot of each line-line inner join in the current contour (see
+    // resolveInnerJoins()).
+    SkTDArray<int> fOuterJoinPivots, fInnerJoinPivots;
 
     SkStrokerPriv::CapProc  fCapper;
     SkStrokerPriv::JoinProc fJoiner;
@@ -249,6 +265,9 @@ private:
     ResultType tangentsMeet(const SkPoint cubic[4], SkQuadConstruct* );
 
     void    finishContour(bool close, bool isLine);
+    void    noteInnerJoin(int outerPtCount, int innerPtCount, const SkPoint& pivot);
+    void    resolveInnerJoins(bool close);
+    void    closeWithoutJoin();
     bool    preJoinTo(const SkPoint&, SkVector* normal, SkVector* unitNormal,
                       bool isLine);
     void    postJoinTo(const SkPoint&, const SkVector& normal,
@@ -279,12 +298,18 @@ bool SkPathStroker::preJoinTo(const SkPoint& currPt, SkVector* normal,
         fFirstNormal = *normal;
         fFirstUnitNormal = *unitNormal;
         fFirstOuterPt.set(prevX + normal->fX, prevY + normal->fY);
+        fFirstIsLine = currIsLine;
 
         fOuter.moveTo(fFirstOuterPt.fX, fFirstOuterPt.fY);
         fInner.moveTo(prevX - normal->fX, prevY - normal->fY);
     } else {    // we have a previous segment
+        int outerPtCount = fOuter.countPoints();
+        int innerPtCount = fInner.countPoints();
         fJoiner(&fOuter, &fInner, fPrevUnitNormal, fPrevPt, *unitNormal,
                 fRadius, fInvMiterLimit, fPrevIsLine, currIsLine);
+        if (fResolveInnerJoins && fPrevIsLine && currIsLine) {
+            this->noteInnerJoin(outerPtCount, innerPtCount, fPrevPt);
+        }
     }
     fPrevIsLine = currIsLine;
     return true;
@@ -304,9 +329,19 @@ void SkPathStroker::finishContour(bool close, bool currIsLine) {
         SkPoint pt;
 
         if (close) {
+            int outerPtCount = fOuter.countPoints();
+            int innerPtCount = fInner.countPoints();
             fJoiner(&fOuter, &fInner, fPrevUnitNormal, fPrevPt,
                     fFirstUnitNormal, fRadius, fInvMiterLimit,
                     fPrevIsLine, currIsLine);
+            if (fResolveInnerJoins && fPrevIsLine && fFirstIsLine) {
+                this->noteInnerJoin(outerPtCount, innerPtCount, fPrevPt);
+            }
+            if (fResolveInnerJoins && fOuter.countPoints() == outerPtCount &&
+                fInner.countPoints() == innerPtCount) {
+                this->closeWithoutJoin();
+            }
+            this->resolveInnerJoins(true);
             fOuter.close();
 
             if (fCanIgnoreCenter) {
@@ -323,6 +358,7 @@ void SkPathStroker::finishContour(bool close, bool currIsLine) {
                 fOuter.close();
             }
         } else {    // add caps to start and end
+            this->resolveInnerJoins(false);
             // cap the end
             fInner.getLastPt(&pt);
             fCapper(&fOuter, fPrevPt, fPrevNormal, pt,
@@ -341,19 +377,108 @@ void SkPathStroker::finishContour(bool close, bool currIsLine) {
     // since we may re-use fInner, we rewind instead of reset, to save on
     // reallocating its internal storage.
     fInner.rewind();
+    fOuterJoinPivots.rewind();
+    fInnerJoinPivots.rewind();
     fSegmentCount = -1;
     fFirstOuterPtIndexInContour = fOuter.countPoints();
 }
 
+// Every joiner routes the side on the inside of the turn through the pivot (HandleInnerJoin),
+// leaving a spike that overlaps the stroke. Remember where it went so resolveInnerJoins() can
+// remove it.
+void SkPathStroker::noteInnerJoin(int outerPtCount, int innerPtCount, const SkPoint& pivot) {
+    if (fInner.countPoints() == innerPtCount + 2 && fInner.getPoint(innerPtCount) == pivot) {
+        *fInnerJoinPivots.append() = innerPtCount;
+    } else if (fOuter.countPoints() == outerPtCount + 2 &&
+               fOuter.getPoint(outerPtCount) == pivot) {
+        *fOuterJoinPivots.append() = outerPtCount;
+    }
+}
+
+// Returns true if segments a and b intersect, storing the intersection in pt.
+static bool intersect_segments(const SkPoint& a0, const SkPoint& a1,
+                               const SkPoint& b0, const SkPoint& b1, SkPoint* pt) {
+    SkVector a = a1 - a0;
+    SkVector b = b1 - b0;
+    SkScalar denom = a.cross(b);
+    if (denom == 0) {
+        return false;
+    }
+    SkVector ab = b0 - a0;
+    SkScalar t = ab.cross(b) / denom;
+    SkScalar u = ab.cross(a) / denom;
+    if (!(t >= 0 && t <= 1 && u >= 0 && u <= 1)) {    // catch NaN values as well
+        return false;
+    }
+    pt->set(a0.fX + a.fX * t, a0.fY + a.fY * t);
+    return true;
+}
+
+// An inner join leaves the points A0 A1 P B0 B1, where A0-A1 and B0-B1 are the offsets of the
+// two lines and P is the pivot. If the offsets cross, collapse A1, P and B0 onto the crossing.
+// The duplicate points are removed when the outline is compacted (see SkStroke::strokePath).
+// A join that closes the contour continues with the contour's first segment instead.
+static void resolve_inner_joins(SkPoint pts[], int end, const SkTDArray<int>& pivots, int start,
+                                bool close) {
+    for (int pivot : pivots) {
+        int b1 = pivot + 2;
+        bool wraps = b1 >= end;
+        if (pivot - 2 < start || (wraps && !close)) {
+            continue;
+        }
+        if (wraps) {
+            b1 = start + 1;
+        }
+        SkPoint cross;
+        if (!intersect_segments(pts[pivot - 2], pts[pivot - 1], pts[pivot + 1], pts[b1], &cross)) {
+            continue;
+        }
+        pts[pivot - 1] = pts[pivot] = pts[pivot + 1] = cross;
+        if (wraps) {
+            pts[start] = cross;
+        }
+    }
+}
+
+// A nearly straight join adds no points, so the next segment's offsets start where the previous
+// segment's ended. The closing join can't do that on its own: each side would step back from its
+// last point to the slightly different first one, doubling back over itself on the inside of the
+// turn. Start each side where it ends instead.
+void SkPathStroker::closeWithoutJoin() {
+    SkPoint last;
+    if (fOuter.getLastPt(&last)) {
+        SkPathRef::Editor ed(&fOuter.fPathRef);
+        ed.writablePoints()[fFirstOuterPtIndexInContour] = last;
+    }
+    if (fInner.getLastPt(&last)) {
+        SkPathRef::Editor ed(&fInner.fPathRef);
+        ed.writablePoints()[0] = last;
+    }
+}
+
+void SkPathStroker::resolveInnerJoins(bool close) {
+    if (fOuterJoinPivots.count() > 0) {
+        SkPathRef::Editor ed(&fOuter.fPathRef);
+        resolve_inner_joins(ed.writablePoints(), fOuter.countPoints(), fOuterJoinPivots,
+                            fFirstOuterPtIndexInContour, close);
+    }
+    if (fInnerJoinPivots.count() > 0) {
+        SkPathRef::Editor ed(&fInner.fPathRef);
+        resolve_inner_joins(ed.writablePoints(), fInner.countPoints(), fInnerJoinPivots, 0,
+                            close);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
-SkPathStroker::SkPathStroker(const SkPath& src,
+SkPathStroker::SkPathStroker(int srcPtCount,
                              SkScalar radius, SkScalar miterLimit,
                              SkPaint::Cap cap, SkPaint::Join join, SkScalar resScale,
-                             bool canIgnoreCenter)
+                             bool canIgnoreCenter, bool resolveInnerJoins)
         : fRadius(radius)
         , fResScale(resScale)
-        , fCanIgnoreCenter(canIgnoreCenter) {
+        , fCanIgnoreCenter(canIgnoreCenter)
+        , fResolveInnerJoins(resolveInnerJoins) {
 
     /*  This is only used when join is miter_join, but we initialize it here
         so that it is always defined, to fis valgrind warnings.
@@ -372,6 +497,7 @@ SkPathStroker::SkPathStroker(const SkPath& src,
     fSegmentCount = -1;
     fFirstOuterPtIndexInContour = 0;
     fPrevIsLine = false;
+    fFirstIsLine = false;
 
     // Need some estimate of how large our final result (fOuter)
     // and our per-contour temp (fInner) will be, so we don't spend
@@ -379,8 +505,8 @@ SkPathStroker::SkPathStroker(const SkPath& src,
     //
     // 3x for result == inner + outer + join (swag)
     // 1x for inner == 'wag' (worst contour length would be better guess)
-    fOuter.incReserve(src.countPoints() * 3);
-    fInner.incReserve(src.countPoints());
+    fOuter.incReserve(srcPtCount * 3);
+    fInner.incReserve(srcPtCount);
     // TODO : write a common error function used by stroking and filling
     // The '4' below matches the fill scan converter's error term
     fInvResScale = PkScalarInvert(resScale * 4);
@@ -1291,6 +1417,7 @@ SkStroke::SkStroke() {
     fCap        = SkPaint::kDefault_Cap;
     fJoin       = SkPaint::kDefault_Join;
     fDoFill     = false;
+    fSimpleOutline = false;
 }
 
 void SkStroke::setWidth(SkScalar width) {
@@ -1311,6 +1438,302 @@ void SkStroke::setJoin(SkPaint::Join join) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+struct OutlineEdge {
+    SkPoint  fPts[2];
+    SkScalar fTop, fBottom;
+    int      fVerb;         // index of the verb the edge belongs to, counted across the path
+    int      fContour;      // index into the contour verb ranges
+};
+
+struct OutlineContour {
+    SkRect   fBounds;       // of the contour's edges, in the same space as the edges
+    SkScalar fArea;         // signed area of the contour's control polygon
+    int      fFirstVerb, fLastVerb;
+    int      fFirstPt, fEndPt;  // the contour's range of OutlinePoints
+};
+
+struct OutlinePoint {
+    SkPoint fPt;
+    bool    fOnCurve;       // false for control points
+};
+
+// Returns the winding number of the closed polygon through pts around p, skipping the control
+// points if onCurveOnly.
+static int polygon_winding(const OutlinePoint pts[], int count, const SkPoint& p,
+                           bool onCurveOnly) {
+    int winding = 0;
+    const SkPoint* prev = nullptr;
+    const SkPoint* first = nullptr;
+    auto addEdge = [&](const SkPoint& a, const SkPoint& b) {
+        if (a.fY <= p.fY && b.fY > p.fY && (b - a).cross(p - a) > 0) {
+            ++winding;
+        } else if (b.fY <= p.fY && a.fY > p.fY && (b - a).cross(p - a) < 0) {
+            --winding;
+        }
+    };
+    for (int i = 0; i < count; ++i) {
+        if (onCurveOnly && !pts[i].fOnCurve) {
+            continue;
+        }
+        if (prev) {
+            addEdge(*prev, pts[i].fPt);
+        } else {
+            first = &pts[i].fPt;
+        }
+        prev = &pts[i].fPt;
+    }
+    if (prev) {
+        addEdge(*prev, *first);
+    }
+    return winding;
+}
+
+// Contours that cross nothing can still lie inside one another. That is harmless for a contour
+// inside one that winds the other way, such as the inner side of a closed stroke, but doubles
+// the winding inside one that winds the same way. Requires that no edges cross, so that one
+// point of the inner contour settles its containment. A point inside one of the outer contour's
+// curve hulls can't be settled from the control points, and counts as nested.
+static bool nested_same_way(const OutlineContour& inner, const OutlineContour& outer,
+                            const SkTDArray<OutlinePoint>& points) {
+    if (!outer.fBounds.contains(inner.fBounds) || (inner.fArea > 0) != (outer.fArea > 0)) {
+        return false;
+    }
+    const SkPoint& p = points[inner.fFirstPt].fPt;
+    const OutlinePoint* pts = points.begin() + outer.fFirstPt;
+    int count = outer.fEndPt - outer.fFirstPt;
+    int winding = polygon_winding(pts, count, p, false);
+    return winding != 0 || winding != polygon_winding(pts, count, p, true);
+}
+
+// Returns true if any contour lies inside another that winds the same way.
+static bool contours_nest_same_way(const SkTDArray<OutlineContour>& contours,
+                                   const SkTDArray<OutlinePoint>& points) {
+    if (contours.count() < 2) {
+        return false;
+    }
+    SkTDArray<int> sorted;
+    sorted.setReserve(contours.count());
+    for (int i = 0; i < contours.count(); ++i) {
+        if (contours[i].fBounds.fLeft <= contours[i].fBounds.fRight) {
+            *sorted.append() = i;
+        }
+    }
+    SkTQSort(sorted.begin(), sorted.end(), [&](int a, int b) {
+        return contours[a].fBounds.fLeft < contours[b].fBounds.fLeft;
+    });
+    SkTDArray<int> active;
+    for (int index : sorted) {
+        const OutlineContour& contour = contours[index];
+        int activeCount = 0;
+        for (int otherIndex : active) {
+            const OutlineContour& other = contours[otherIndex];
+            if (other.fBounds.fRight <= contour.fBounds.fLeft) {
+                continue;
+            }
+            active[activeCount++] = otherIndex;
+            if (SkRect::Intersects(contour.fBounds, other.fBounds) &&
+                (nested_same_way(contour, other, points) ||
+                 nested_same_way(other, contour, points))) {
+                return true;
+            }
+        }
+        active.setCount(activeCount);
+        *active.append() = index;
+    }
+    return false;
+}
+
+static bool edges_adjacent(const OutlineEdge& a, const OutlineEdge& b,
+                           const SkTDArray<OutlineContour>& contours) {
+    if (a.fContour != b.fContour) {
+        return false;
+    }
+    int lo = std::min(a.fVerb, b.fVerb);
+    int hi = std::max(a.fVerb, b.fVerb);
+    const OutlineContour& contour = contours[a.fContour];
+    return hi - lo == 1 || (lo == contour.fFirstVerb && hi == contour.fLastVerb);
+}
+
+// Adjacent edges share an end point, so for them only a crossing in both interiors (or a
+// doubling back over each other) counts.
+static bool edges_cross(const OutlineEdge& a, const OutlineEdge& b, bool adjacent) {
+    SkVector da = a.fPts[1] - a.fPts[0];
+    SkVector db = b.fPts[1] - b.fPts[0];
+    SkVector ab = b.fPts[0] - a.fPts[0];
+    SkScalar denom = da.cross(db);
+    if (denom == 0) {
+        if (ab.cross(da) != 0) {
+            return false;   // parallel
+        }
+        SkScalar len2 = da.dot(da);
+        SkScalar t0 = ab.dot(da) / len2;
+        SkScalar t1 = (b.fPts[1] - a.fPts[0]).dot(da) / len2;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        return adjacent ? std::min(t1, 1.0f) > std::max(t0, 0.0f) : t1 >= 0 && t0 <= 1;
+    }
+    SkScalar t = ab.cross(db) / denom;
+    SkScalar u = ab.cross(da) / denom;
+    if (adjacent) {
+        return t > 0 && t < 1 && u > 0 && u < 1;
+    }
+    return t >= 0 && t <= 1 && u >= 0 && u <= 1;
+}
+
+// Copies src to dst without the zero-length lines left behind by resolved inner joins, and
+// returns true if no two edges of the result cross and no contour lies inside another that winds
+// the same way. A curve lies within its control polygon, so the polygon's edges stand in for it;
+// this may report a crossing that the curve itself avoids, which only costs an unneeded
+// Simplify().
+static bool compact_outline(const SkPath& src, SkPath* dst) {
+    SkTDArray<OutlineEdge> edges;
+    SkTDArray<OutlineContour> contours;
+    SkTDArray<OutlinePoint> points;
+    SkPoint firstPt = {0, 0}, lastPt = {0, 0};
+    int verb = 0;
+
+    // The sweep below runs along y; transpose wide paths so it runs along their long axis and
+    // keeps the active list short.
+    const SkRect& bounds = src.getBounds();
+    bool transpose = bounds.width() > bounds.height();
+
+    auto addEdge = [&](const SkPoint& p0, const SkPoint& p1) {
+        if (p0 != p1) {
+            OutlineEdge* edge = edges.append();
+            edge->fPts[0] = transpose ? SkPoint::Make(p0.fY, p0.fX) : p0;
+            edge->fPts[1] = transpose ? SkPoint::Make(p1.fY, p1.fX) : p1;
+            edge->fTop = std::min(edge->fPts[0].fY, edge->fPts[1].fY);
+            edge->fBottom = std::max(edge->fPts[0].fY, edge->fPts[1].fY);
+            edge->fVerb = verb;
+            edge->fContour = contours.count() - 1;
+            SkRect& contourBounds = contours.back().fBounds;
+            contourBounds.fLeft = std::min({contourBounds.fLeft, edge->fPts[0].fX,
+                                            edge->fPts[1].fX});
+            contourBounds.fRight = std::max({contourBounds.fRight, edge->fPts[0].fX,
+                                             edge->fPts[1].fX});
+            contourBounds.fTop = std::min(contourBounds.fTop, edge->fTop);
+            contourBounds.fBottom = std::max(contourBounds.fBottom, edge->fBottom);
+        }
+    };
+    auto addPoints = [&](const SkPoint pts[], int count) {
+        for (int i = 0; i < count; ++i) {
+            OutlinePoint* point = points.append();
+            point->fPt = transpose ? SkPoint::Make(pts[i].fY, pts[i].fX) : pts[i];
+            point->fOnCurve = i == count - 1;
+        }
+    };
+    auto addPolygon = [&](const SkPoint pts[], int count) {
+        for (int i = 0; i < count; ++i) {
+            addEdge(pts[i], pts[(i + 1) % count]);
+        }
+        ++verb;
+    };
+    auto finishContour = [&]() {
+        if (contours.count() > 0) {
+            // the closing edge is drawn whether or not the contour was explicitly closed
+            if (lastPt != firstPt) {
+                addEdge(lastPt, firstPt);
+                ++verb;
+            }
+            OutlineContour& contour = contours.back();
+            contour.fLastVerb = verb - 1;
+            contour.fEndPt = points.count();
+            contour.fArea = 0;
+            for (int i = contour.fFirstPt; i < contour.fEndPt; ++i) {
+                int next = i + 1 < contour.fEndPt ? i + 1 : contour.fFirstPt;
+                contour.fArea += points[i].fPt.cross(points[next].fPt);
+            }
+        }
+    };
+
+    dst->setFillType(src.getFillType());
+    dst->incReserve(src.countPoints());
+    for (auto [v, pts, w] : SkPathPriv::Iterate(src)) {
+        switch (v) {
+            case SkPathVerb::kMove:
+                finishContour();
+                contours.append()->fFirstVerb = verb;
+                contours.back().fFirstPt = points.count();
+                contours.back().fBounds.setLTRB(PK_ScalarInfinity, PK_ScalarInfinity,
+                                                PK_ScalarNegativeInfinity,
+                                                PK_ScalarNegativeInfinity);
+                dst->moveTo(pts[0]);
+                addPoints(pts, 1);
+                firstPt = lastPt = pts[0];
+                break;
+            case SkPathVerb::kLine:
+                if (pts[1] != lastPt) {
+                    dst->lineTo(pts[1]);
+                    addEdge(lastPt, pts[1]);
+                    addPoints(pts + 1, 1);
+                    ++verb;
+                    lastPt = pts[1];
+                }
+                break;
+            case SkPathVerb::kQuad:
+                dst->quadTo(pts[1], pts[2]);
+                addPolygon(pts, 3);
+                addPoints(pts + 1, 2);
+                lastPt = pts[2];
+                break;
+            case SkPathVerb::kConic:
+                dst->conicTo(pts[1], pts[2], *w);
+                addPolygon(pts, 3);
+                addPoints(pts + 1, 2);
+                lastPt = pts[2];
+                break;
+            case SkPathVerb::kCubic:
+                dst->cubicTo(pts[1], pts[2], pts[3]);
+                addPolygon(pts, 4);
+                addPoints(pts + 1, 3);
+                lastPt = pts[3];
+                break;
+            case SkPathVerb::kClose:
+                dst->close();
+                break;
+        }
+    }
+    finishContour();
+
+    // Sweep top to bottom, testing each edge against the earlier edges it overlaps vertically.
+    SkTQSort(edges.begin(), edges.end(), [](const OutlineEdge& a, const OutlineEdge& b) {
+        return a.fTop < b.fTop;
+    });
+    SkTDArray<int> active;
+    for (int i = 0; i < edges.count(); ++i) {
+        const OutlineEdge& edge = edges[i];
+        SkScalar left = std::min(edge.fPts[0].fX, edge.fPts[1].fX);
+        SkScalar right = std::max(edge.fPts[0].fX, edge.fPts[1].fX);
+        int activeCount = 0;
+        for (int index : active) {
+            const OutlineEdge& other = edges[index];
+            if (other.fBottom < edge.fTop) {
+                continue;
+            }
+            active[activeCount++] = index;
+            if (other.fVerb == edge.fVerb ||
+                std::max(other.fPts[0].fX, other.fPts[1].fX) < left ||
+                std::min(other.fPts[0].fX, other.fPts[1].fX) > right) {
+                continue;
+            }
+            if (edges_cross(edge, other, edges_adjacent(edge, other, contours))) {
+                return false;
+            }
+        }
+        active.setCount(activeCount);
+        *active.append() = i;
+    }
+    return !contours_nest_same_way(contours, points);
+}
+
+static void make_simple_outline(SkPath* path) {
+    SkPath compact;
+    if (compact_outline(*path, &compact) || !Simplify(compact, path)) {
+        path->swap(compact);
+    }
+}
+
 // If src==dst, then we use a tmp path to record the stroke, and then swap
 // its contents with src when we're done.
 class AutoTmpPath {
@@ -1362,13 +1785,34 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
         }
     }
 
+    // If src is a circle or a rrect with circular corners, its stroke is just two concentric
+    // rrects, so skip the generic stroker
+    {
+        SkRect oval;
+        SkRRect rrect;
+        SkPathDirection dir;
+        bool isRRect = SkPathPriv::IsRRect(src, &rrect, &dir, nullptr);
+        if (!isRRect && SkPathPriv::IsOval(src, &oval, &dir, nullptr) &&
+            oval.width() == oval.height()) {
+            rrect.setOval(oval);
+            isRRect = true;
+        }
+        if (isRRect && this->strokeRRect(rrect, dst, dir)) {
+            // our answer should preserve the inverseness of the src
+            if (src.isInverseFillType()) {
+                dst->toggleInverseFillType();
+            }
+            return;
+        }
+    }
+
     // We can always ignore centers for stroke and fill convex line-only paths
     // TODO: remove the line-only restriction
     bool ignoreCenter = fDoFill && (src.getSegmentMasks() == SkPath::kLine_SegmentMask) &&
                         src.isLastContourClosed() && src.isConvex();
 
-    SkPathStroker   stroker(src, radius, fMiterLimit, this->getCap(), this->getJoin(),
-                            fResScale, ignoreCenter);
+    SkPathStroker   stroker(src.countPoints(), radius, fMiterLimit, this->getCap(), this->getJoin(),
+                            fResScale, ignoreCenter, fSimpleOutline);
     SkPath::Iter    iter(src, false);
     SkPath::Verb    lastSegment = SkPath::kMove_Verb;
 
@@ -1450,6 +1894,10 @@ DONE:
 #endif
     }
 
+    if (fSimpleOutline) {
+        make_simple_outline(dst);
+    }
+
     // our answer should preserve the inverseness of the src
     if (src.isInverseFillType()) {
         dst->toggleInverseFillType();
@@ -1534,4 +1982,154 @@ void SkStroke::strokeRect(const SkRect& origRect, SkPath* dst,
         dst->addRect(r, reverse_direction(dir));
     }
 }
-}  // namespace pk
\ No newline at end of file
+
+static bool radii_fit(SkScalar r0, SkScalar r1, SkScalar side) {
+    return r0 + r1 <= side || SkScalarNearlyEqual(r0 + r1, side);
+}
+
+bool SkStroke::strokeRRect(const SkRRect& rrect, SkPath* dst, SkPathDirection dir) const {
+    SkScalar radius = PkScalarHalf(fWidth);
+    if (radius <= 0) {
+        return false;
+    }
+
+    // Offsetting a circular arc by the stroke radius gives another circular arc with the same
+    // center, so the outer edge grows each corner radius by the stroke radius and the inner edge
+    // shrinks it (down to a sharp corner).
+    SkVector outerRadii[4], innerRadii[4];
+    for (int i = 0; i < 4; ++i) {
+        SkVector r = rrect.radii((SkRRect::Corner)i);
+        if (r.fX != r.fY || r.fX <= 0) {
+            return false;
+        }
+        outerRadii[i].set(r.fX + radius, r.fX + radius);
+        SkScalar innerR = std::max(r.fX - radius, 0.0f);
+        innerRadii[i].set(innerR, innerR);
+    }
+
+    SkRect inner = rrect.rect().makeInset(radius, radius);
+    bool hasInner = !fDoFill && !inner.isEmpty();
+    if (hasInner) {
+        // If a large corner eats into its neighbor, the inner edge is no longer a rrect.
+        SkScalar w = inner.width();
+        SkScalar h = inner.height();
+        if (!radii_fit(innerRadii[SkRRect::kUpperLeft_Corner].fX,
+                       innerRadii[SkRRect::kUpperRight_Corner].fX, w) ||
+            !radii_fit(innerRadii[SkRRect::kLowerLeft_Corner].fX,
+                       innerRadii[SkRRect::kLowerRight_Corner].fX, w) ||
+            !radii_fit(innerRadii[SkRRect::kUpperLeft_Corner].fY,
+                       innerRadii[SkRRect::kLowerLeft_Corner].fY, h) ||
+            !radii_fit(innerRadii[SkRRect::kUpperRight_Corner].fY,
+                       innerRadii[SkRRect::kLowerRight_Corner].fY, h)) {
+            return false;
+        }
+    }
+
+    dst->reset();
+
+    SkRRect rr;
+    rr.setRectRadii(rrect.rect().makeOutset(radius, radius), outerRadii);
+    dst->addRRect(rr, dir);
+
+    if (hasInner) {
+        rr.setRectRadii(inner, innerRadii);
+        dst->addRRect(rr, reverse_direction(dir));
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+SkStreamingStroke::SkStreamingStroke(const SkStroke& stroke, int ptCountEstimate)
+        : fStroker(new SkPathStroker(ptCountEstimate, PkScalarHalf(stroke.fWidth),
+                                     stroke.fMiterLimit, stroke.getCap(), stroke.getJoin(),
+                                     stroke.fResScale, false, stroke.fSimpleOutline))
+        , fSimpleOutline(stroke.fSimpleOutline)
+        , fHasLastPt(false)
+        , fHasPendingLine(false)
+        , fLastIsLine(false) {}
+
+SkStreamingStroke::~SkStreamingStroke() {}
+
+bool SkStreamingStroke::getLastPt(SkPoint* lastPt) const {
+    if (fHasLastPt) {
+        *lastPt = fLastPt;
+    }
+    return fHasLastPt;
+}
+
+// strokePath() lets a zero-length line at the start of a contour peek ahead with the iterator to
+// see if a later segment supplies a tangent. We can't see ahead, so such a line is held back
+// until the next segment (or the end of the contour) settles it.
+void SkStreamingStroke::flushPendingLine() {
+    if (fHasPendingLine) {
+        fHasPendingLine = false;
+        fStroker->lineTo(fLastPt);
+    }
+}
+
+void SkStreamingStroke::dropPendingLine(const SkPoint pts[], int count) {
+    for (int i = 0; i < count; ++i) {
+        if (pts[i] != fLastPt) {
+            fHasPendingLine = false;
+            return;
+        }
+    }
+}
+
+void SkStreamingStroke::moveTo(const SkPoint& pt) {
+    this->flushPendingLine();
+    fStroker->moveTo(pt);
+    fLastPt = pt;
+    fHasLastPt = true;
+}
+
+void SkStreamingStroke::lineTo(const SkPoint& pt) {
+    if (fStroker->lineNeedsLookAhead(pt)) {
+        fHasPendingLine = true;
+    } else {
+        fHasPendingLine = false;
+        fStroker->lineTo(pt);
+    }
+    fLastPt = pt;
+    fLastIsLine = true;
+}
+
+void SkStreamingStroke::quadTo(const SkPoint& pt1, const SkPoint& pt2) {
+    if (fHasPendingLine) {
+        const SkPoint pts[] = { pt1, pt2 };
+        this->dropPendingLine(pts, PK_ARRAY_COUNT(pts));
+    }
+    fStroker->quadTo(pt1, pt2);
+    fLastPt = pt2;
+    fLastIsLine = false;
+}
+
+void SkStreamingStroke::conicTo(const SkPoint& pt1, const SkPoint& pt2, SkScalar weight) {
+    if (fHasPendingLine) {
+        const SkPoint pts[] = { pt1, pt2 };
+        this->dropPendingLine(pts, PK_ARRAY_COUNT(pts));
+    }
+    fStroker->conicTo(pt1, pt2, weight);
+    fLastPt = pt2;
+    fLastIsLine = false;
+}
+
+void SkStreamingStroke::cubicTo(const SkPoint& pt1, const SkPoint& pt2, const SkPoint& pt3) {
+    if (fHasPendingLine) {
+        const SkPoint pts[] = { pt1, pt2, pt3 };
+        this->dropPendingLine(pts, PK_ARRAY_COUNT(pts));
+    }
+    fStroker->cubicTo(pt1, pt2, pt3);
+    fLastPt = pt3;
+    fLastIsLine = false;
+}
+
+void SkStreamingStroke::done(SkPath* dst) {
+    this->flushPendingLine();
+    fStroker->done(dst, fLastIsLine);
+    if (fSimpleOutline) {
+        make_simple_outline(dst);
+    }
+}
+}  // namespace pk
@@ -10,9 +10,13 @@
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPoint.h"
+#include "include/core/SkRRect.h"
 #include "include/private/SkTo.h"
+#include "src/core/SkPathMeasurePriv.h"
 #include "src/core/SkStrokerPriv.h"
 
+#include <memory>
+
 namespace pk {
 /** \class SkStroke
     SkStroke is the utility class that constructs paths by stroking
@@ -36,6 +40,16 @@ public:
     bool    getDoFill() const { return SkToBool(fDoFill); }
     void    setDoFill(bool doFill) { fDoFill = SkToU8(doFill); }
 
+    /**
+     *  SimpleOutline asks strokePath() for a result with no self-overlap, for consumers that need
+     *  simple polygons. The overlap the stroker leaves at each inner join between two lines is
+     *  resolved while stroking; only if the outline still crosses itself (e.g. the source does,
+     *  or a segment is shorter than the stroke is wide) is it passed through Simplify().
+     *      Default is false.
+     */
+    bool    getSimpleOutline() const { return fSimpleOutline; }
+    void    setSimpleOutline(bool simple) { fSimpleOutline = simple; }
+
     /**
      *  ResScale is the "intended" resolution for the output.
      *      Default is 1.0.
@@ -54,6 +68,15 @@ public:
      */
     void    strokeRect(const SkRect& rect, SkPath* result,
                        SkPathDirection = SkPathDirection::kCW) const;
+
+    /**
+     *  Stroke the specified rrect (or circle) analytically, as an outer rrect and a reversed
+     *  inner one. This is only exact when every corner is a circular arc, since the offset of an
+     *  elliptical arc is not itself an ellipse; for any other rrect this returns false and leaves
+     *  result untouched.
+     */
+    bool    strokeRRect(const SkRRect& rrect, SkPath* result,
+                        SkPathDirection = SkPathDirection::kCW) const;
     void    strokePath(const SkPath& path, SkPath*) const;
 
     ////////////////////////////////////////////////////////////////
@@ -63,7 +86,46 @@ private:
     SkScalar    fResScale;
     uint8_t     fCap, fJoin;
     bool        fDoFill;
+    bool        fSimpleOutline;
 
     friend class SkPaint;
+    friend class SkStreamingStroke;
+};
+
+class SkPathStroker;
+
+/** \class SkStreamingStroke
+    Strokes geometry one verb at a time, as it is generated, using the settings of an SkStroke.
+    Producers that would otherwise build a temporary path only to stroke it (e.g. dashing) can
+    feed their segments here directly. Every moveTo() begins a new open contour. The SkStroke's
+    simple outline setting applies to the whole result, as it does in SkStroke::strokePath().
+*/
+class SkStreamingStroke final : public SkSegmentSink {
+public:
+    /** ptCountEstimate is used to reserve storage for the result. */
+    SkStreamingStroke(const SkStroke& stroke, int ptCountEstimate);
+    ~SkStreamingStroke() override;
+
+    bool getLastPt(SkPoint* lastPt) const override;
+
+    void moveTo(const SkPoint& pt) override;
+    void lineTo(const SkPoint& pt) override;
+    void quadTo(const SkPoint& pt1, const SkPoint& pt2) override;
+    void conicTo(const SkPoint& pt1, const SkPoint& pt2, SkScalar weight) override;
+    void cubicTo(const SkPoint& pt1, const SkPoint& pt2, const SkPoint& pt3) override;
+
+    /** Finishes the last contour and stores the stroked result in dst. */
+    void done(SkPath* dst);
+
+private:
+    void flushPendingLine();
+    void dropPendingLine(const SkPoint pts[], int count);
+
+    std::unique_ptr<SkPathStroker> fStroker;
+    SkPoint fLastPt;
+    bool    fSimpleOutline;
+    bool    fHasLastPt;
+    bool    fHasPendingLine;
+    bool    fLastIsLine;
 };
 }  // namespace pk
@@ -20,6 +20,7 @@ SkStrokeRec::SkStrokeRec(InitStyle s) {
     fCap = SkPaint::kDefault_Cap;
     fJoin = SkPaint::kDefault_Join;
     fStrokeAndFill = false;
+    fSimpleOutline = false;
 }
 
 SkStrokeRec::SkStrokeRec(const SkPaint& paint, SkScalar resScale) {
@@ -32,6 +33,7 @@ SkStrokeRec::SkStrokeRec(const SkPaint& paint, SkPaint::Style styleOverride, SkS
 
 void SkStrokeRec::init(const SkPaint& paint, SkPaint::Style style, SkScalar resScale) {
     fResScale = resScale;
+    fSimpleOutline = false;
 
     switch (style) {
         case SkPaint::kFill_Style:
@@ -108,6 +110,7 @@ bool SkStrokeRec::applyToPath(SkPath* dst, const SkPath& src) const {
     stroker.setWidth(fWidth);
     stroker.setDoFill(fStrokeAndFill);
     stroker.setResScale(fResScale);
+    stroker.setSimpleOutline(fSimpleOutline);
     stroker.strokePath(src, dst);
     return true;
 }
@@ -688,7 +688,99 @@ Poly* GrAATriangulator::tessellate(const VertexList& mesh, const Comparator& c)
     }
 }
 
-int GrAATriangulator::polysToAATriangles(Poly* polys, std::vector<float>* data) const {
+bool GrAATriangulator::convexPathToAATriangles(float tolerance,
+                                               const SkRect& clipBounds,
+                                               VertexWriter* writer,
+                                               int* count) const {
+    VertexList contour;
+    bool isLinear;
+    int n = this->pathToConvexContour(tolerance, clipBounds, &contour, &isLinear);
+    if (n < 3) {
+        // Degenerate contours still go through the general algorithm, which decides whether they
+        // produce any coverage.
+        return false;
+    }
+    std::vector<Vertex*> vertices;
+    vertices.reserve(n);
+    for (Vertex* v = contour.fHead; v; v = v->fNext) {
+        vertices.push_back(v);
+    }
+
+    // Offset each edge by half a pixel towards the interior (inner) and away from it (outer). Every
+    // other vertex of a convex polygon lies on the interior side of an edge.
+    double radius = 0.5;
+    std::vector<Line> inner, outer;
+    inner.reserve(n);
+    outer.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        Line line(vertices[i], vertices[(i + 1) % n]);
+        line.normalize();
+        double side = line.dist(vertices[(i + 2) % n]->fPoint);
+        if (line.magSq() == 0 || side == 0) {
+            return false;
+        }
+        double offset = side > 0 ? radius : -radius;
+        inner.push_back(Line(line.fA, line.fB, line.fC - offset));
+        outer.push_back(Line(line.fA, line.fB, line.fC + offset));
+    }
+
+    // Vertex i joins edges i - 1 and i.
+    std::vector<Vertex*> innerVertices, outerVertices;
+    innerVertices.reserve(n);
+    outerVertices.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        int prev = (i + n - 1) % n;
+        SkVector prevNormal = {PkDoubleToScalar(inner[prev].fA), PkDoubleToScalar(inner[prev].fB)};
+        SkVector normal = {PkDoubleToScalar(inner[i].fA), PkDoubleToScalar(inner[i].fB)};
+        SkPoint innerPoint, outerPoint;
+        // Pointy vertices are mitered by strokeBoundary(); leave them to it.
+        if (normal.dot(prevNormal) < -kCosMiterAngle ||
+            !inner[prev].intersect(inner[i], &innerPoint) ||
+            !outer[prev].intersect(outer[i], &outerPoint) || !innerPoint.isFinite() ||
+            !outerPoint.isFinite()) {
+            return false;
+        }
+        Vertex* innerVertex = fAlloc->make<Vertex>(innerPoint, 255);
+        Vertex* outerVertex = fAlloc->make<Vertex>(outerPoint, 0);
+        innerVertex->fPartner = outerVertex;
+        outerVertex->fPartner = innerVertex;
+        innerVertices.push_back(innerVertex);
+        outerVertices.push_back(outerVertex);
+    }
+
+    // The inner polygon inverts when the shape is thinner than a pixel somewhere; the general
+    // algorithm collapses those edges instead.
+    for (int i = 0; i < n; ++i) {
+        int next = (i + 1) % n;
+        SkVector edge = vertices[next]->fPoint - vertices[i]->fPoint;
+        SkVector innerEdge = innerVertices[next]->fPoint - innerVertices[i]->fPoint;
+        if (edge.dot(innerEdge) <= 0) {
+            return false;
+        }
+    }
+
+    int64_t count64 = (int64_t)(n - 2 + 2 * n) * (TRIANGULATOR_WIREFRAME ? 6 : 3);
+    if (!this->reserveTriangles(count64, writer)) {
+        *count = 0;
+        return true;
+    }
+    for (int i = 1; i < n - 1; ++i) {
+        this->emitTriangle(innerVertices[0], innerVertices[i], innerVertices[i + 1], 0, writer);
+    }
+    for (int i = 0; i < n; ++i) {
+        int next = (i + 1) % n;
+        Vertex* v0 = innerVertices[i];
+        Vertex* v1 = innerVertices[next];
+        Vertex* v2 = outerVertices[next];
+        Vertex* v3 = outerVertices[i];
+        this->emitTriangle(v0, v1, v2, 0 /*winding*/, writer);
+        this->emitTriangle(v0, v2, v3, 0 /*winding*/, writer);
+    }
+    *count = this->finishTriangles(writer);
+    return true;
+}
+
+int GrAATriangulator::polysToAATriangles(Poly* polys, VertexWriter* data) const {
     int64_t count64 = CountPoints(polys, SkPathFillType::kWinding);
     // Count the points from the outer mesh.
     for (Vertex* v = fOuterMesh.fHead; v; v = v->fNext) {
@@ -696,14 +788,9 @@ int GrAATriangulator::polysToAATriangles(Poly* polys, std::vector<float>* data)
             count64 += TRIANGULATOR_WIREFRAME ? 12 : 6;
         }
     }
-    if (0 == count64 || count64 > INT32_MAX) {
+    if (!this->reserveTriangles(count64, data)) {
         return 0;
     }
-    int count = count64;
-    int vertexStride = 2 + 1;
-
-    data->reserve(count * vertexStride);
-    TESS_LOG("emitting %d verts\n", count);
     this->polysToTriangles(polys, data, SkPathFillType::kWinding);
     // Emit the triangles from the outer mesh.
     for (Vertex* v = fOuterMesh.fHead; v; v = v->fNext) {
@@ -716,6 +803,42 @@ int GrAATriangulator::polysToAATriangles(Poly* polys, std::vector<float>* data)
             this->emitTriangle(v0, v2, v3, 0 /*winding*/, data);
         }
     }
-    return static_cast<int>(data->size()) / vertexStride;
+    return this->finishTriangles(data);
+}
+
+int GrAATriangulator::PathToAATrianglesInParallel(const SkPath& path,
+                                                  SkScalar tolerance,
+                                                  const SkRect& clipBounds,
+                                                  std::vector<float>* vertex,
+                                                  int maxThreads) {
+    // The alpha ramps reach half a pixel past each contour, and vertices round to a quarter pixel.
+    // Contours closer than that must share a mesh so their ramps are merged rather than overlapped.
+    constexpr SkScalar kRampOutset = 1;
+    std::vector<SkPath> groups;
+    if (!SplitDisjointContours(path, kRampOutset, &groups)) {
+        return PathToAATriangles(path, tolerance, clipBounds, vertex);
+    }
+    TriangulateGroups(
+            groups, maxThreads,
+            [&](int group, std::vector<float>* groupVertex, bool* groupIsLinear) {
+                PathToAATriangles(groups[group], tolerance, clipBounds, groupVertex);
+                *groupIsLinear = true;
+            },
+            vertex);
+    return static_cast<int>(vertex->size()) / 3;
+}
+
+int GrAATriangulator::PathToAATrianglesWithBudget(const SkPath& path,
+                                                  SkScalar tolerance,
+                                                  const SkRect& clipBounds,
+                                                  int maxPoints,
+                                                  std::vector<float>* vertex,
+                                                  SkScalar* error) {
+    SkScalar budgetTolerance;
+    SkPath simplified;
+    if (!FitPointBudget(path, tolerance, maxPoints, &budgetTolerance, &simplified, error)) {
+        return PathToAATriangles(path, budgetTolerance, clipBounds, vertex);
+    }
+    return PathToAATriangles(simplified, budgetTolerance, clipBounds, vertex);
 }
 }  // namespace pk
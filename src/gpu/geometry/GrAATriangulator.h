@@ -18,13 +18,49 @@ public:
                                  SkScalar tolerance,
                                  const SkRect& clipBounds,
                                  std::vector<float>* vertex) {
-        SkArenaAlloc alloc(kArenaDefaultChunkSize);
-        GrAATriangulator aaTriangulator(path, &alloc);
-        aaTriangulator.fRoundVerticesToQuarterPixel = true;
-        aaTriangulator.fEmitCoverage = true;
-        bool isLinear;
-        Poly* polys = aaTriangulator.pathToPolys(tolerance, clipBounds, &isLinear);
-        return aaTriangulator.polysToAATriangles(polys, vertex);
+        VertexWriter writer(vertex);
+        return PathToAATriangles(path, tolerance, clipBounds, &writer);
+    }
+
+    // Same as PathToAATriangles, but triangulates groups of contours whose antialiased bounds
+    // don't overlap on up to maxThreads threads (0 uses one per hardware thread).
+    static int PathToAATrianglesInParallel(const SkPath& path,
+                                           SkScalar tolerance,
+                                           const SkRect& clipBounds,
+                                           std::vector<float>* vertex,
+                                           int maxThreads);
+
+    // Same as PathToAATriangles, but keeps the linearized path within maxPoints points (see
+    // GrTriangulator::FitPointBudget). *error receives a bound on the distance between the
+    // triangulated outline and the path.
+    static int PathToAATrianglesWithBudget(const SkPath& path,
+                                           SkScalar tolerance,
+                                           const SkRect& clipBounds,
+                                           int maxPoints,
+                                           std::vector<float>* vertex,
+                                           SkScalar* error);
+
+    // Same as PathToAATriangles, but writes the vertices straight into memory locked from
+    // allocator.
+    static int PathToAATriangles(const SkPath& path,
+                                 SkScalar tolerance,
+                                 const SkRect& clipBounds,
+                                 SkPath::VertexAllocator* allocator) {
+        VertexWriter writer(allocator);
+        return PathToAATriangles(path, tolerance, clipBounds, &writer);
+    }
+
+    // Same as PathToAATriangles, but writes each vertex of the mesh only once and describes the
+    // triangles with an index buffer. Returns the number of indices, or 0 if the vertices do not
+    // fit in IndexType.
+    template <typename IndexType>
+    static int PathToIndexedAATriangles(const SkPath& path,
+                                        SkScalar tolerance,
+                                        const SkRect& clipBounds,
+                                        std::vector<float>* vertex,
+                                        std::vector<IndexType>* indices) {
+        VertexWriter writer(vertex, indices);
+        return PathToAATriangles(path, tolerance, clipBounds, &writer);
     }
 
     // Structs used by GrAATriangulator internals.
@@ -48,6 +84,24 @@ public:
     };
 
 private:
+    static int PathToAATriangles(const SkPath& path,
+                                 SkScalar tolerance,
+                                 const SkRect& clipBounds,
+                                 VertexWriter* writer) {
+        SkArenaAlloc alloc(kArenaDefaultChunkSize);
+        GrAATriangulator aaTriangulator(path, &alloc);
+        aaTriangulator.fRoundVerticesToQuarterPixel = true;
+        aaTriangulator.fEmitCoverage = true;
+        bool isLinear;
+        int count;
+        if (IsSingleConvexContour(path) &&
+            aaTriangulator.convexPathToAATriangles(tolerance, clipBounds, writer, &count)) {
+            return count;
+        }
+        Poly* polys = aaTriangulator.pathToPolys(tolerance, clipBounds, &isLinear);
+        return aaTriangulator.polysToAATriangles(polys, writer);
+    }
+
     GrAATriangulator(const SkPath& path, SkArenaAlloc* alloc) : GrTriangulator(path, alloc) {}
 
     // For screenspace antialiasing, the algorithm is modified as follows:
@@ -67,9 +121,18 @@ private:
     //     new antialiased mesh from those vertices:
     void strokeBoundary(EdgeList* boundary, VertexList* innerMesh, const Comparator&) const;
 
+    // Convex fast path: a single convex contour is displaced by half a pixel as in (5d), and the
+    // inner polygon is emitted as a fan surrounded by a ring of alpha ramps. Returns false without
+    // writing anything if a vertex is too sharp or the inner polygon would invert, in which case
+    // the general algorithm must run.
+    bool convexPathToAATriangles(float tolerance,
+                                 const SkRect& clipBounds,
+                                 VertexWriter* writer,
+                                 int* count) const;
+
     // Run steps 3-6 above on the new mesh, and produce antialiased triangles.
     Poly* tessellate(const VertexList& mesh, const Comparator&) const override;
-    int polysToAATriangles(Poly*, std::vector<float>*) const;
+    int polysToAATriangles(Poly*, VertexWriter*) const;
 
     // Additional helpers and driver functions.
     void makeEvent(SSEdge*, EventList* events) const;
@@ -8,6 +8,8 @@
 #include "src/gpu/geometry/GrPathUtils.h"
 #include "src/gpu/geometry/GrWangsFormula.h"
 
+#include "include/private/SkNx.h"
+
 namespace pk {
 static float tolerance_to_wangs_precision(float srcTol) {
     // The GrPathUtil API defines tolerance as the max distance the linear segment can be from
@@ -26,4 +28,117 @@ uint32_t GrPathUtils::cubicPointCount(const SkPoint points[], SkScalar tol) {
     return max_bezier_vertices(
             GrWangsFormula::cubic_log2(tolerance_to_wangs_precision(tol), points));
 }
+
+static int segment_count(float wangs, SkScalar tol) {
+    if (!(tol > 0) || !(wangs > 1)) {
+        // Also catches NaN.
+        return 1;
+    }
+    return PkScalarCeilToInt(std::min(wangs, (float)GrPathUtils::kMaxPointsPerCurve));
+}
+
+int GrPathUtils::quadraticSegmentCount(const SkPoint points[3], SkScalar tol) {
+    return segment_count(
+            GrWangsFormula::quadratic(tolerance_to_wangs_precision(tol), points), tol);
+}
+
+int GrPathUtils::cubicSegmentCount(const SkPoint points[4], SkScalar tol) {
+    return segment_count(GrWangsFormula::cubic(tolerance_to_wangs_precision(tol), points), tol);
+}
+
+int GrPathUtils::conicSegmentCount(const SkPoint points[3], SkScalar weight, SkScalar tol) {
+    return segment_count(
+            GrWangsFormula::conic(tolerance_to_wangs_precision(tol), points, weight), tol);
+}
+
+// The curves are evaluated in power form, relative to the first point, at four steps at once.
+// Unlike forward differencing, each point is computed on its own, so rounding error doesn't
+// accumulate along the curve. The last point is the end point, copied exactly.
+namespace {
+struct QuadSteps {
+    QuadSteps(const SkPoint pts[3]) : fX0(pts[0].fX), fY0(pts[0].fY) {
+        float dx1 = pts[1].fX - pts[0].fX, dy1 = pts[1].fY - pts[0].fY;
+        fAX = (pts[2].fX - pts[0].fX) - dx1 - dx1;
+        fAY = (pts[2].fY - pts[0].fY) - dy1 - dy1;
+        fBX = dx1 + dx1;
+        fBY = dy1 + dy1;
+    }
+
+    void eval(const Sk4f& t, Sk4f* x, Sk4f* y) const {
+        *x = (fAX * t + fBX) * t + fX0;
+        *y = (fAY * t + fBY) * t + fY0;
+    }
+
+    Sk4f fX0, fY0, fAX, fAY, fBX, fBY;
+};
+
+struct ConicSteps {
+    ConicSteps(const SkPoint pts[3], float w) : fX0(pts[0].fX), fY0(pts[0].fY) {
+        // numer(t) = A t^2 + B t, denom(t) = 1 + D (t - t^2)
+        float wx1 = (pts[1].fX - pts[0].fX) * w, wy1 = (pts[1].fY - pts[0].fY) * w;
+        fAX = (pts[2].fX - pts[0].fX) - wx1 - wx1;
+        fAY = (pts[2].fY - pts[0].fY) - wy1 - wy1;
+        fBX = wx1 + wx1;
+        fBY = wy1 + wy1;
+        fD = (w - 1) * 2;
+    }
+
+    void eval(const Sk4f& t, Sk4f* x, Sk4f* y) const {
+        Sk4f invDenom = Sk4f(1) / (fD * (t - t * t) + 1);
+        *x = (fAX * t + fBX) * t * invDenom + fX0;
+        *y = (fAY * t + fBY) * t * invDenom + fY0;
+    }
+
+    Sk4f fX0, fY0, fAX, fAY, fBX, fBY, fD;
+};
+
+struct CubicSteps {
+    CubicSteps(const SkPoint pts[4]) : fX0(pts[0].fX), fY0(pts[0].fY) {
+        float dx1 = pts[1].fX - pts[0].fX, dy1 = pts[1].fY - pts[0].fY;
+        float dx2 = pts[2].fX - pts[0].fX, dy2 = pts[2].fY - pts[0].fY;
+        fAX = (pts[3].fX - pts[0].fX) + (dx1 - dx2) * 3;
+        fAY = (pts[3].fY - pts[0].fY) + (dy1 - dy2) * 3;
+        fBX = (dx2 - dx1 - dx1) * 3;
+        fBY = (dy2 - dy1 - dy1) * 3;
+        fCX = dx1 * 3;
+        fCY = dy1 * 3;
+    }
+
+    void eval(const Sk4f& t, Sk4f* x, Sk4f* y) const {
+        *x = ((fAX * t + fBX) * t + fCX) * t + fX0;
+        *y = ((fAY * t + fBY) * t + fCY) * t + fY0;
+    }
+
+    Sk4f fX0, fY0, fAX, fAY, fBX, fBY, fCX, fCY;
+};
+}  // namespace
+
+template <typename Steps>
+static void flatten_curve(const Steps& curve, const SkPoint& end, int segmentCount,
+                          SkPoint dst[]) {
+    PkASSERT(segmentCount >= 1);
+    const Sk4f steps(0, 1, 2, 3);
+    const Sk4f h(1.0f / segmentCount);
+    for (int i = 1; i < segmentCount; i += 4) {
+        Sk4f x, y;
+        curve.eval((steps + static_cast<float>(i)) * h, &x, &y);
+        for (int k = 0, n = std::min(4, segmentCount - i); k < n; ++k) {
+            dst[i - 1 + k].set(x[k], y[k]);
+        }
+    }
+    dst[segmentCount - 1] = end;
+}
+
+void GrPathUtils::flattenQuadratic(const SkPoint points[3], int segmentCount, SkPoint dst[]) {
+    flatten_curve(QuadSteps(points), points[2], segmentCount, dst);
+}
+
+void GrPathUtils::flattenCubic(const SkPoint points[4], int segmentCount, SkPoint dst[]) {
+    flatten_curve(CubicSteps(points), points[3], segmentCount, dst);
+}
+
+void GrPathUtils::flattenConic(const SkPoint points[3], SkScalar weight, int segmentCount,
+                               SkPoint dst[]) {
+    flatten_curve(ConicSteps(points, weight), points[2], segmentCount, dst);
+}
 }  // namespace pk
@@ -30,6 +30,20 @@ static const int kMaxPointsPerCurve = 1 << 10;
 // linearize the cubic Bezier (e.g. generateQuadraticPoints below) to the given error tolerance.
 // This is a power of two and will not exceed kMaxPointsPerCurve.
 uint32_t cubicPointCount(const SkPoint points[], SkScalar tol);
+
+// Returns the number of evenly spaced (in the parametric sense) line segments that keep the
+// linearized curve within tol of the true curve, according to Wang's formula. The result is in
+// [1, kMaxPointsPerCurve]; a non-positive tol returns 1.
+int quadraticSegmentCount(const SkPoint points[3], SkScalar tol);
+int cubicSegmentCount(const SkPoint points[4], SkScalar tol);
+int conicSegmentCount(const SkPoint points[3], SkScalar weight, SkScalar tol);
+
+// Evaluates the curve at segmentCount evenly spaced parametric steps, several steps at a time, and
+// writes the segmentCount points that follow points[0] to dst. The last point written is always
+// the curve's end point.
+void flattenQuadratic(const SkPoint points[3], int segmentCount, SkPoint dst[]);
+void flattenCubic(const SkPoint points[4], int segmentCount, SkPoint dst[]);
+void flattenConic(const SkPoint points[3], SkScalar weight, int segmentCount, SkPoint dst[]);
 }  // namespace GrPathUtils
 }  // namespace pk
 
@@ -9,11 +9,17 @@
 
 #include "src/gpu/geometry/GrPathUtils.h"
 
+#include "include/private/SkFloatBits.h"
+#include "include/private/SkTDArray.h"
 #include "include/private/SkTPin.h"
 #include "src/core/SkGeometry.h"
+#include "src/core/SkParallel.h"
+#include "src/core/SkPathPriv.h"
 #include "src/core/SkPointPriv.h"
 
 #include <algorithm>
+#include <numeric>
+#include <queue>
 
 #if TRIANGULATOR_LOGGING
 #define TESS_LOG printf
@@ -33,6 +39,7 @@ using EdgeList = GrTriangulator::EdgeList;
 using Poly = GrTriangulator::Poly;
 using MonotonePoly = GrTriangulator::MonotonePoly;
 using Comparator = GrTriangulator::Comparator;
+using VertexWriter = GrTriangulator::VertexWriter;
 
 template <class T, T* T::*Prev, T* T::*Next>
 static void list_insert(T* t, T* prev, T* next, T** head, T** tail) {
@@ -84,17 +91,37 @@ static inline float GrNormalizeByteToFloat(uint8_t value) {
     return value * ONE_OVER_255;
 }
 
-static inline void emit_vertex(Vertex* v, bool emitCoverage, std::vector<float>* data) {
-    data->push_back(v->fPoint.fX);
-    data->push_back(v->fPoint.fY);
+static inline float* write_vertex(const Vertex* v, bool emitCoverage, float* data) {
+    *data++ = v->fPoint.fX;
+    *data++ = v->fPoint.fY;
 
     if (emitCoverage) {
-        data->push_back(GrNormalizeByteToFloat(v->fAlpha));
+        *data++ = GrNormalizeByteToFloat(v->fAlpha);
+    }
+    return data;
+}
+
+static inline void emit_vertex(Vertex* v, bool emitCoverage, VertexWriter* writer) {
+    if (!writer->isIndexed()) {
+        writer->fData = write_vertex(v, emitCoverage, writer->fData);
+        return;
+    }
+    if (v->fIndex < 0) {
+        v->fIndex = static_cast<int>(writer->fVertexCount++);
+        size_t size = writer->fVertices->size();
+        writer->fVertices->resize(size + (emitCoverage ? 3 : 2));
+        write_vertex(v, emitCoverage, writer->fVertices->data() + size);
+    }
+    if (writer->fIndices16) {
+        // Truncated indices are caught by finishTriangles().
+        writer->fIndices16->push_back(static_cast<uint16_t>(v->fIndex));
+    } else {
+        writer->fIndices32->push_back(static_cast<uint32_t>(v->fIndex));
     }
 }
 
 static void emit_triangle(
-        Vertex* v0, Vertex* v1, Vertex* v2, bool emitCoverage, std::vector<float>* data) {
+        Vertex* v0, Vertex* v1, Vertex* v2, bool emitCoverage, VertexWriter* data) {
     TESS_LOG("emit_triangle %g (%g, %g) %d\n", v0->fID, v0->fPoint.fX, v0->fPoint.fY, v0->fAlpha);
     TESS_LOG("              %g (%g, %g) %d\n", v1->fID, v1->fPoint.fX, v1->fPoint.fY, v1->fAlpha);
     TESS_LOG("              %g (%g, %g) %d\n", v2->fID, v2->fPoint.fX, v2->fPoint.fY, v2->fAlpha);
@@ -320,7 +347,7 @@ void GrTriangulator::MonotonePoly::addEdge(Edge* edge) {
 }
 
 void GrTriangulator::emitMonotonePoly(const MonotonePoly* monotonePoly,
-                                      std::vector<float>* data) const {
+                                      VertexWriter* data) const {
     Edge* e = monotonePoly->fFirstEdge;
     VertexList vertices;
     vertices.append(e->fTop);
@@ -366,7 +393,7 @@ void GrTriangulator::emitMonotonePoly(const MonotonePoly* monotonePoly,
 }
 
 void GrTriangulator::emitTriangle(
-        Vertex* prev, Vertex* curr, Vertex* next, int winding, std::vector<float>* data) const {
+        Vertex* prev, Vertex* curr, Vertex* next, int winding, VertexWriter* data) const {
     if (winding > 0) {
         // Ensure our triangles always wind in the same direction as if the path had been
         // triangulated as a simple fan (a la red book).
@@ -440,7 +467,7 @@ Poly* GrTriangulator::Poly::addEdge(Edge* e, Side side, SkArenaAlloc* alloc) {
     }
     return poly;
 }
-void GrTriangulator::emitPoly(const Poly* poly, std::vector<float>* data) const {
+void GrTriangulator::emitPoly(const Poly* poly, VertexWriter* data) const {
     if (poly->fCount < 3) {
         return;
     }
@@ -1271,6 +1298,83 @@ template <CompareFunc sweep_lt> static void merge_sort(VertexList* vertices) {
     sorted_merge<sweep_lt>(&front, &back, vertices);
 }
 
+// For large meshes, chasing the list's pointers through merge_sort is slower than sorting a
+// contiguous array. radix_sort() packs each vertex's sweep order into a 64-bit key, runs an LSD
+// radix sort over (key, vertex) pairs, and relinks the list in the sorted order.
+
+static constexpr int kRadixSortMinCount = 256;
+
+// Maps a float to a uint32_t whose unsigned order matches the float's order.
+static inline uint32_t sortable_float_bits(float f) {
+    // sweep_lt() treats -0 and 0 as equal, so they must map to the same key.
+    uint32_t bits = SkFloat2Bits(f == 0 ? 0.0f : f);
+    return (bits & 0x80000000) ? ~bits : bits | 0x80000000;
+}
+
+static void radix_sort(VertexList* vertices, int count, bool horizontal) {
+    struct Item {
+        uint64_t fKey;
+        Vertex* fVertex;
+    };
+    std::unique_ptr<Item[]> storage(new Item[2 * count]);
+    Item* items = storage.get();
+    Item* scratch = items + count;
+    // merge_sort() leaves equal vertices in reverse list order. The radix sort is stable, so
+    // reading the list backwards reproduces that order exactly.
+    int i = 0;
+    for (Vertex* v = vertices->fTail; v; v = v->fPrev, ++i) {
+        // Horizontal sweeps order by increasing X, then decreasing Y; vertical sweeps order by
+        // increasing Y, then increasing X. See sweep_lt_horiz and sweep_lt_vert.
+        uint64_t key = horizontal ? (uint64_t)sortable_float_bits(v->fPoint.fX) << 32 |
+                                            ~sortable_float_bits(v->fPoint.fY)
+                                  : (uint64_t)sortable_float_bits(v->fPoint.fY) << 32 |
+                                            sortable_float_bits(v->fPoint.fX);
+        items[i] = {key, v};
+    }
+
+    constexpr int kDigitBits = 11;
+    constexpr int kBuckets = 1 << kDigitBits;
+    constexpr int kPasses = (64 + kDigitBits - 1) / kDigitBits;
+    std::unique_ptr<int[]> histograms(new int[kPasses * kBuckets]());
+    for (i = 0; i < count; ++i) {
+        uint64_t key = items[i].fKey;
+        for (int pass = 0; pass < kPasses; ++pass) {
+            histograms[pass * kBuckets + ((key >> (pass * kDigitBits)) & (kBuckets - 1))]++;
+        }
+    }
+    for (int pass = 0; pass < kPasses; ++pass) {
+        int* histogram = histograms.get() + pass * kBuckets;
+        int shift = pass * kDigitBits;
+        if (histogram[(items[0].fKey >> shift) & (kBuckets - 1)] == count) {
+            // Every key has the same digit; this pass wouldn't change the order.
+            continue;
+        }
+        int offset = 0;
+        for (int b = 0; b < kBuckets; ++b) {
+            int bucketCount = histogram[b];
+            histogram[b] = offset;
+            offset += bucketCount;
+        }
+        for (i = 0; i < count; ++i) {
+            scratch[histogram[(items[i].fKey >> shift) & (kBuckets - 1)]++] = items[i];
+        }
+        std::swap(items, scratch);
+    }
+
+    Vertex* prev = nullptr;
+    for (i = 0; i < count; ++i) {
+        Vertex* v = items[i].fVertex;
+        v->fPrev = prev;
+        if (prev) {
+            prev->fNext = v;
+        }
+        prev = v;
+    }
+    prev->fNext = nullptr;
+    vertices->fHead = items[0].fVertex;
+    vertices->fTail = prev;
+}
+
 #if TRIANGULATOR_LOGGING
 void VertexList::dump() const {
     for (Vertex* v = fHead; v; v = v->fNext) {
@@ -1529,7 +1633,13 @@ void GrTriangulator::SortMesh(VertexList* vertices, const Comparator& c) {
     }
 
     // Sort vertices in Y (secondarily in X).
-    if (c.fDirection == Comparator::Direction::kHorizontal) {
+    int count = 0;
+    for (Vertex* v = vertices->fHead; v; v = v->fNext) {
+        ++count;
+    }
+    if (count >= kRadixSortMinCount) {
+        radix_sort(vertices, count, c.fDirection == Comparator::Direction::kHorizontal);
+    } else if (c.fDirection == Comparator::Direction::kHorizontal) {
         merge_sort<sweep_lt_horiz>(vertices);
     } else {
         merge_sort<sweep_lt_vert>(vertices);
@@ -1564,7 +1674,7 @@ Poly* GrTriangulator::contoursToPolys(VertexList* contours, int contourCnt) cons
 
 // Stage 6: Triangulate the monotone polygons into a vertex buffer.
 void GrTriangulator::polysToTriangles(Poly* polys,
-                                      std::vector<float>* data,
+                                      VertexWriter* data,
                                       SkPathFillType overrideFillType) const {
     for (Poly* poly = polys; poly; poly = poly->fNext) {
         if (apply_fill_type(overrideFillType, poly)) {
@@ -1623,6 +1733,56 @@ Poly* GrTriangulator::pathToPolys(float tolerance, const SkRect& clipBounds, boo
     return this->contoursToPolys(contours.get(), contourCnt);
 }
 
+bool GrTriangulator::IsSingleConvexContour(const SkPath& path) {
+    return !path.isInverseFillType() && path.isConvex() && get_contour_count(path, 0) == 1;
+}
+
+int GrTriangulator::pathToConvexContour(float tolerance,
+                                        const SkRect& clipBounds,
+                                        VertexList* contour,
+                                        bool* isLinear) const {
+    this->pathToContours(tolerance, clipBounds, contour, isLinear);
+    if (!contour->fHead) {
+        return 0;
+    }
+    this->sanitizeContours(contour, 1);
+    int count = 0;
+    bool turnsLeft = false, turnsRight = false;
+    for (Vertex* v = contour->fHead; v; v = v->fNext) {
+        // Curve flattening and clamping can leave small concavities in a convex path.
+        Vertex* next = v->fNext ? v->fNext : contour->fHead;
+        Vertex* nextNext = next->fNext ? next->fNext : contour->fHead;
+        double cross = Line(v, next).dist(nextNext->fPoint);
+        turnsLeft |= cross > 0;
+        turnsRight |= cross < 0;
+        ++count;
+    }
+    return turnsLeft && turnsRight ? -1 : count;
+}
+
+bool GrTriangulator::convexPathToTriangles(float tolerance,
+                                           const SkRect& clipBounds,
+                                           VertexWriter* writer,
+                                           bool* isLinear,
+                                           int* count) const {
+    VertexList contour;
+    int n = this->pathToConvexContour(tolerance, clipBounds, &contour, isLinear);
+    if (n < 0) {
+        return false;
+    }
+    if (n < 3 || !this->reserveTriangles((n - 2) * (TRIANGULATOR_WIREFRAME ? 6 : 3), writer)) {
+        *count = 0;
+        return true;
+    }
+    // The fan follows the contour, so its triangles wind the same way as the general path's.
+    Vertex* first = contour.fHead;
+    for (Vertex* v = first->fNext; v->fNext; v = v->fNext) {
+        emit_triangle(first, v, v->fNext, fEmitCoverage, writer);
+    }
+    *count = this->finishTriangles(writer);
+    return true;
+}
+
 int64_t GrTriangulator::CountPoints(Poly* polys, SkPathFillType overrideFillType) {
     int64_t count = 0;
     for (Poly* poly = polys; poly; poly = poly->fNext) {
@@ -1635,10 +1795,9 @@ int64_t GrTriangulator::CountPoints(Poly* polys, SkPathFillType overrideFillType
 
 // Stage 6: Triangulate the monotone polygons into a vertex buffer.
 
-int GrTriangulator::polysToTriangles(Poly* polys, std::vector<float>* vertex) const {
-    int64_t count64 = CountPoints(polys, fPath.getFillType());
+bool GrTriangulator::reserveTriangles(int64_t count64, VertexWriter* writer) const {
     if (0 == count64 || count64 > PK_MaxS32) {
-        return 0;
+        return false;
     }
     int count = count64;
 
@@ -1647,9 +1806,638 @@ int GrTriangulator::polysToTriangles(Poly* polys, std::vector<float>* vertex) co
         vertexStride += 1;
     }
 
-    vertex->reserve(count * vertexStride);
     TESS_LOG("emitting %d verts\n", count);
-    polysToTriangles(polys, vertex, fPath.getFillType());
-    return static_cast<int>(vertex->size()) / vertexStride;
+    if (writer->fAllocator) {
+        // count is an upper bound on the number of vertices the polys emit.
+        writer->fData = static_cast<float*>(
+                writer->fAllocator->lock(vertexStride * sizeof(float), count));
+        writer->fDataStart = writer->fData;
+        return writer->fData != nullptr;
+    }
+    if (writer->fIndices16) {
+        writer->fIndices16->reserve(writer->fIndices16->size() + count);
+    } else if (writer->fIndices32) {
+        writer->fIndices32->reserve(writer->fIndices32->size() + count);
+    }
+    if (writer->isIndexed()) {
+        writer->fVerticesStart = writer->fVertices->size();
+        writer->fIndicesStart = writer->indexCount();
+        writer->fVertexCount = writer->fVerticesStart / vertexStride;
+        // A mesh shares each of its vertices between several triangles, so an indexed buffer
+        // rarely needs more than a third of the unindexed size.
+        writer->fVertices->reserve(writer->fVertices->size() + (count / 3 + 3) * vertexStride);
+        return true;
+    }
+    size_t size = writer->fVertices->size();
+    writer->fVertices->resize(size + count * vertexStride);
+    writer->fData = writer->fVertices->data() + size;
+    writer->fDataStart = writer->fVertices->data();
+    return true;
+}
+
+int GrTriangulator::finishTriangles(VertexWriter* writer) const {
+    int vertexStride = fEmitCoverage ? 3 : 2;
+    if (writer->fAllocator) {
+        int actualCount = static_cast<int>(writer->fData - writer->fDataStart) / vertexStride;
+        writer->fAllocator->unlock(actualCount);
+        return actualCount;
+    }
+    if (!writer->isIndexed()) {
+        writer->fVertices->resize(writer->fData - writer->fDataStart);
+        return static_cast<int>(writer->fVertices->size()) / vertexStride;
+    }
+    if (writer->fIndices16 && writer->fVertexCount > UINT16_MAX + 1) {
+        writer->fVertices->resize(writer->fVerticesStart);
+        writer->fIndices16->resize(writer->fIndicesStart);
+        return 0;
+    }
+    return static_cast<int>(writer->indexCount());
+}
+
+int GrTriangulator::polysToTriangles(Poly* polys, VertexWriter* writer) const {
+    if (!this->reserveTriangles(CountPoints(polys, fPath.getFillType()), writer)) {
+        return 0;
+    }
+    polysToTriangles(polys, writer, fPath.getFillType());
+    return this->finishTriangles(writer);
+}
+
+// Parallel triangulation of disjoint contours.
+
+static int find_root(std::vector<int>* parents, int i) {
+    auto& p = *parents;
+    while (p[i] != i) {
+        p[i] = p[p[i]];
+        i = p[i];
+    }
+    return i;
+}
+
+bool GrTriangulator::SplitDisjointContours(const SkPath& path,
+                                           SkScalar outset,
+                                           std::vector<SkPath>* groups) {
+    if (path.isInverseFillType() || !path.isFinite()) {
+        // The inverse fill's clip contour overlaps everything.
+        return false;
+    }
+    std::vector<SkPath> contours;
+    for (auto [verb, pts, w] : SkPathPriv::Iterate(path)) {
+        switch (verb) {
+            case SkPathVerb::kMove:
+                contours.emplace_back();
+                contours.back().moveTo(pts[0]);
+                break;
+            case SkPathVerb::kLine:
+                contours.back().lineTo(pts[1]);
+                break;
+            case SkPathVerb::kQuad:
+                contours.back().quadTo(pts[1], pts[2]);
+                break;
+            case SkPathVerb::kConic:
+                contours.back().conicTo(pts[1], pts[2], *w);
+                break;
+            case SkPathVerb::kCubic:
+                contours.back().cubicTo(pts[1], pts[2], pts[3]);
+                break;
+            case SkPathVerb::kClose:
+                contours.back().close();
+                break;
+        }
+    }
+    int count = static_cast<int>(contours.size());
+    if (count < 2) {
+        return false;
+    }
+
+    // Curves stay inside the bounds of their control points, so contours whose bounds don't
+    // overlap never contribute to each other's winding. Join overlapping contours, sweeping along
+    // the longer axis of the path so that fewer contours are active at once.
+    bool horizontal = path.getBounds().width() >= path.getBounds().height();
+    std::vector<SkRect> bounds(count);
+    for (int i = 0; i < count; ++i) {
+        SkRect r = contours[i].getBounds().makeOutset(outset, outset);
+        bounds[i] = horizontal ? r : SkRect::MakeLTRB(r.fTop, r.fLeft, r.fBottom, r.fRight);
+    }
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&](int a, int b) { return bounds[a].fLeft < bounds[b].fLeft; });
+    std::vector<int> parents(count);
+    std::iota(parents.begin(), parents.end(), 0);
+    std::vector<int> active;
+    for (int i : order) {
+        const SkRect& r = bounds[i];
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&](int j) { return bounds[j].fRight < r.fLeft; }),
+                     active.end());
+        for (int j : active) {
+            if (bounds[j].fTop <= r.fBottom && r.fTop <= bounds[j].fBottom) {
+                parents[find_root(&parents, j)] = find_root(&parents, i);
+            }
+        }
+        active.push_back(i);
+    }
+
+    // Number the groups in the order of their first contour, and keep contours in path order.
+    std::vector<int> groupIndices(count, -1);
+    groups->clear();
+    for (int i = 0; i < count; ++i) {
+        int root = find_root(&parents, i);
+        if (groupIndices[root] < 0) {
+            groupIndices[root] = static_cast<int>(groups->size());
+            groups->emplace_back();
+            groups->back().setFillType(path.getFillType());
+        }
+        (*groups)[groupIndices[root]].addPath(contours[i]);
+    }
+    return groups->size() > 1;
+}
+
+bool GrTriangulator::TriangulateGroups(const std::vector<SkPath>& groups,
+                                       int maxThreads,
+                                       const GroupTriangulator& triangulate,
+                                       std::vector<float>* vertex,
+                                       std::vector<size_t>* groupOffsets) {
+    int count = static_cast<int>(groups.size());
+    // Hand out the biggest groups first so that one doesn't start last and finish late.
+    std::vector<int> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return groups[a].countPoints() > groups[b].countPoints();
+    });
+    std::vector<std::vector<float>> results(count);
+    std::unique_ptr<bool[]> linear(new bool[count]);
+    SkParallelFor(count, SkResolveThreadCount(maxThreads), [&](int i) {
+        triangulate(order[i], &results[order[i]], &linear[order[i]]);
+    });
+
+    size_t size = vertex->size();
+    for (const auto& result : results) {
+        size += result.size();
+    }
+    vertex->reserve(size);
+    bool isLinear = true;
+    if (groupOffsets) {
+        groupOffsets->clear();
+        groupOffsets->reserve(count + 1);
+    }
+    for (int i = 0; i < count; ++i) {
+        if (groupOffsets) {
+            groupOffsets->push_back(vertex->size());
+        }
+        vertex->insert(vertex->end(), results[i].begin(), results[i].end());
+        isLinear &= linear[i];
+    }
+    if (groupOffsets) {
+        groupOffsets->push_back(vertex->size());
+    }
+    return isLinear;
+}
+
+int GrTriangulator::PathToTrianglesInParallel(const SkPath& path,
+                                              SkScalar tolerance,
+                                              const SkRect& clipBounds,
+                                              std::vector<float>* vertex,
+                                              bool* isLinear,
+                                              int maxThreads) {
+    std::vector<SkPath> groups;
+    if (!SplitDisjointContours(path, 0, &groups)) {
+        return PathToTriangles(path, tolerance, clipBounds, vertex, isLinear);
+    }
+    *isLinear = TriangulateGroups(
+            groups, maxThreads,
+            [&](int group, std::vector<float>* groupVertex, bool* groupIsLinear) {
+                PathToTriangles(groups[group], tolerance, clipBounds, groupVertex, groupIsLinear);
+            },
+            vertex);
+    return static_cast<int>(vertex->size()) / 2;
+}
+
+// Tiled triangulation.
+
+// Clips the closed polygon in src to one side of an axis-aligned line, Sutherland-Hodgman style.
+template <bool kVertical, bool kKeepGreater>
+static void clip_polygon_to_line(const SkTDArray<SkPoint>& src,
+                                 SkScalar value,
+                                 SkTDArray<SkPoint>* dst) {
+    dst->rewind();
+    int count = src.count();
+    if (count == 0) {
+        return;
+    }
+    auto coord = [](const SkPoint& p) { return kVertical ? p.fX : p.fY; };
+    auto inside = [&](const SkPoint& p) {
+        return kKeepGreater ? coord(p) >= value : coord(p) <= value;
+    };
+    SkPoint prev = src[count - 1];
+    bool prevInside = inside(prev);
+    for (int i = 0; i < count; ++i) {
+        const SkPoint& p = src[i];
+        bool pInside = inside(p);
+        if (pInside != prevInside) {
+            SkScalar t = (value - coord(prev)) / (coord(p) - coord(prev));
+            SkPoint* crossing = dst->append();
+            *crossing = prev + (p - prev) * t;
+            (kVertical ? crossing->fX : crossing->fY) = value;
+        }
+        if (pInside) {
+            *dst->append() = p;
+        }
+        prev = p;
+        prevInside = pInside;
+    }
+}
+
+// Clips a closed polygon to rect. The parts outside are replaced by runs along the rect's edges,
+// so every point inside rect keeps its winding number.
+static void clip_polygon_to_rect(const SkTDArray<SkPoint>& src,
+                                 const SkRect& rect,
+                                 SkTDArray<SkPoint>* dst,
+                                 SkTDArray<SkPoint>* scratch) {
+    clip_polygon_to_line<true, true>(src, rect.fLeft, scratch);
+    clip_polygon_to_line<true, false>(*scratch, rect.fRight, dst);
+    clip_polygon_to_line<false, true>(*dst, rect.fTop, scratch);
+    clip_polygon_to_line<false, false>(*scratch, rect.fBottom, dst);
+}
+
+int GrTriangulator::PathToTiledTriangles(const SkPath& path,
+                                         SkScalar tolerance,
+                                         const SkRect& clipBounds,
+                                         SkScalar tileWidth,
+                                         SkScalar tileHeight,
+                                         std::vector<float>* vertex,
+                                         std::vector<int>* tileOffsets,
+                                         bool* isLinear,
+                                         int maxThreads) {
+    *isLinear = !(path.getSegmentMasks() &
+                  (SkPath::kQuad_SegmentMask | SkPath::kConic_SegmentMask |
+                   SkPath::kCubic_SegmentMask));
+    tileOffsets->clear();
+    if (!path.isFinite() || !clipBounds.isFinite() || clipBounds.isEmpty()) {
+        return 0;
+    }
+    if (!(tileWidth > 0)) {
+        tileWidth = clipBounds.width();
+    }
+    if (!(tileHeight > 0)) {
+        tileHeight = clipBounds.height();
+    }
+    int64_t columns64 = pk_float_ceil2int(clipBounds.width() / tileWidth);
+    int64_t rows64 = pk_float_ceil2int(clipBounds.height() / tileHeight);
+    if (columns64 * rows64 > kMaxTiles) {
+        return 0;
+    }
+    int columns = std::max(1, static_cast<int>(columns64));
+    int rows = std::max(1, static_cast<int>(rows64));
+    std::vector<SkRect> tiles(columns * rows);
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < columns; ++x) {
+            SkScalar left = clipBounds.fLeft + x * tileWidth;
+            SkScalar top = clipBounds.fTop + y * tileHeight;
+            tiles[y * columns + x] = SkRect::MakeLTRB(
+                    left, top, x == columns - 1 ? clipBounds.fRight : left + tileWidth,
+                    y == rows - 1 ? clipBounds.fBottom : top + tileHeight);
+        }
+    }
+
+    // Linearize the whole path once, then hand each contour to the tiles its bounds touch.
+    class TileSink : public SkPath::FlattenSink {
+    public:
+        TileSink(const SkRect& clipBounds, SkScalar tileWidth, SkScalar tileHeight, int columns,
+                 int rows, const std::vector<SkRect>& tiles, std::vector<SkPath>* tilePaths)
+                : fClipBounds(clipBounds), fTileWidth(tileWidth), fTileHeight(tileHeight)
+                , fColumns(columns), fRows(rows), fTiles(tiles), fTilePaths(tilePaths) {}
+
+        void polyline(const SkPoint pts[], int count, bool) override {
+            SkRect bounds;
+            if (count < 3 || !bounds.setBoundsCheck(pts, count) ||
+                !bounds.intersects(fClipBounds)) {
+                return;
+            }
+            int x0 = this->column(bounds.fLeft), x1 = this->column(bounds.fRight);
+            int y0 = this->row(bounds.fTop), y1 = this->row(bounds.fBottom);
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    int tile = y * fColumns + x;
+                    if (fTiles[tile].contains(bounds)) {
+                        (*fTilePaths)[tile].addPoly(pts, count, true);
+                        continue;
+                    }
+                    fPolygon.rewind();
+                    fPolygon.append(count, pts);
+                    clip_polygon_to_rect(fPolygon, fTiles[tile], &fClipped, &fScratch);
+                    if (fClipped.count() >= 3) {
+                        (*fTilePaths)[tile].addPoly(fClipped.begin(), fClipped.count(), true);
+                    }
+                }
+            }
+        }
+
+    private:
+        int column(SkScalar x) const {
+            return SkTPin(pk_float_floor2int((x - fClipBounds.fLeft) / fTileWidth), 0,
+                          fColumns - 1);
+        }
+        int row(SkScalar y) const {
+            return SkTPin(pk_float_floor2int((y - fClipBounds.fTop) / fTileHeight), 0,
+                          fRows - 1);
+        }
+
+        SkRect fClipBounds;
+        SkScalar fTileWidth, fTileHeight;
+        int fColumns, fRows;
+        const std::vector<SkRect>& fTiles;
+        std::vector<SkPath>* fTilePaths;
+        SkTDArray<SkPoint> fPolygon, fClipped, fScratch;
+    };
+
+    std::vector<SkPath> tilePaths(tiles.size());
+    for (auto& tilePath : tilePaths) {
+        tilePath.setFillType(path.getFillType());
+    }
+    TileSink sink(clipBounds, tileWidth, tileHeight, columns, rows, tiles, &tilePaths);
+    path.flatten(tolerance, SkMatrix::I(), &sink);
+
+    std::vector<size_t> offsets;
+    TriangulateGroups(
+            tilePaths, maxThreads,
+            [&](int tile, std::vector<float>* tileVertex, bool* tileIsLinear) {
+                *tileIsLinear = true;
+                if (!tilePaths[tile].isEmpty()) {
+                    PathToTriangles(tilePaths[tile], tolerance, tiles[tile], tileVertex,
+                                    tileIsLinear);
+                } else if (path.isInverseFillType()) {
+                    // Nothing reaches this tile, so the inverse fill covers all of it.
+                    SkPoint quad[4];
+                    tiles[tile].toQuad(quad);
+                    for (int i : {0, 1, 2, 0, 2, 3}) {
+                        tileVertex->push_back(quad[i].fX);
+                        tileVertex->push_back(quad[i].fY);
+                    }
+                }
+            },
+            vertex, &offsets);
+    tileOffsets->reserve(offsets.size());
+    for (size_t offset : offsets) {
+        tileOffsets->push_back(static_cast<int>(offset / 2));
+    }
+    return tileOffsets->back() - tileOffsets->front();
+}
+
+// Point budget.
+
+// Returns the number of points SkPath::flatten() produces for path at tolerance. *curvePoints
+// receives the share of them from curves split into more than one segment, which a coarser
+// tolerance could still reduce, and *thinContours the number of contours left with fewer than
+// three points, which have no area to triangulate.
+static int64_t flattened_point_count(const SkPath& path,
+                                     SkScalar tolerance,
+                                     int64_t* curvePoints,
+                                     int* thinContours) {
+    int64_t count = 0;
+    *curvePoints = 0;
+    *thinContours = 0;
+    int64_t contourPoints = 0;
+    SkPoint firstPt = {0, 0}, lastPt = {0, 0};
+    auto finishContour = [&]() {
+        // the polyline of a contour that ends where it starts doesn't repeat that point
+        if (contourPoints > 0 && contourPoints - (lastPt == firstPt) < 3) {
+            ++*thinContours;
+        }
+    };
+    for (auto [verb, pts, w] : SkPathPriv::Iterate(path)) {
+        int n = 0;
+        switch (verb) {
+            case SkPathVerb::kMove:
+                finishContour();
+                contourPoints = 0;
+                firstPt = lastPt = pts[0];
+                n = 1;
+                break;
+            case SkPathVerb::kLine:
+                n = 1;
+                lastPt = pts[1];
+                break;
+            case SkPathVerb::kQuad:
+                n = GrPathUtils::quadraticSegmentCount(pts, tolerance);
+                lastPt = pts[2];
+                break;
+            case SkPathVerb::kConic:
+                n = GrPathUtils::conicSegmentCount(pts, *w, tolerance);
+                lastPt = pts[2];
+                break;
+            case SkPathVerb::kCubic:
+                n = GrPathUtils::cubicSegmentCount(pts, tolerance);
+                lastPt = pts[3];
+                break;
+            case SkPathVerb::kClose:
+                break;
+        }
+        count += n;
+        contourPoints += n;
+        if (n > 1) {
+            *curvePoints += n;
+        }
+    }
+    finishContour();
+    return count;
+}
+
+// Drops points from closed polylines, cheapest first, until at most maxPoints remain or every
+// polyline is down to a triangle. Each remaining segment carries a bound on how far the points
+// it replaced are from it: dropping p between a and b costs max(bound(a, p), bound(p, b)) plus the
+// distance from p to segment ab, since the old segments stay within that distance of ab. Returns
+// the largest bound of any remaining segment.
+static SkScalar simplify_polylines(const SkTDArray<SkPoint>& points,
+                                   const SkTDArray<int>& starts,
+                                   int maxPoints,
+                                   SkPath* simplified) {
+    int count = points.count();
+    int polylineCount = starts.count() - 1;
+    SkTDArray<int> prev, next, polyline, stamp;
+    SkTDArray<SkScalar> segmentError;  // Bound for the segment from i to next[i].
+    prev.setCount(count);
+    next.setCount(count);
+    polyline.setCount(count);
+    stamp.setCount(count);
+    segmentError.setCount(count);
+    SkTDArray<int> remaining;
+    remaining.setCount(polylineCount);
+    for (int c = 0; c < polylineCount; ++c) {
+        int start = starts[c], end = starts[c + 1];
+        remaining[c] = end - start;
+        for (int i = start; i < end; ++i) {
+            prev[i] = i == start ? end - 1 : i - 1;
+            next[i] = i == end - 1 ? start : i + 1;
+            polyline[i] = c;
+            stamp[i] = 0;
+            segmentError[i] = 0;
+        }
+    }
+    const SkPoint* pts = points.begin();
+    auto cost = [&](int i) {
+        return std::max(segmentError[prev[i]], segmentError[i]) +
+               SkPointPriv::DistanceToLineSegmentBetween(pts[i], pts[prev[i]], pts[next[i]]);
+    };
+    struct Candidate {
+        SkScalar fCost;
+        int fIndex;
+        int fStamp;
+        bool operator<(const Candidate& o) const { return fCost > o.fCost; }
+    };
+    std::priority_queue<Candidate> queue;
+    for (int i = 0; i < count; ++i) {
+        queue.push({cost(i), i, 0});
+    }
+    int live = count;
+    SkScalar maxError = 0;
+    while (live > maxPoints && !queue.empty()) {
+        Candidate candidate = queue.top();
+        queue.pop();
+        int i = candidate.fIndex;
+        if (candidate.fStamp != stamp[i] || remaining[polyline[i]] <= 3) {
+            continue;
+        }
+        int a = prev[i], b = next[i];
+        next[a] = b;
+        prev[b] = a;
+        segmentError[a] = candidate.fCost;
+        maxError = std::max(maxError, candidate.fCost);
+        stamp[i] = -1;
+        --remaining[polyline[i]];
+        --live;
+        for (int j : {a, b}) {
+            queue.push({cost(j), j, ++stamp[j]});
+        }
+    }
+
+    SkTDArray<SkPoint> polygon;
+    for (int c = 0; c < polylineCount; ++c) {
+        int first = starts[c];
+        while (stamp[first] < 0) {
+            ++first;
+        }
+        polygon.rewind();
+        int i = first;
+        do {
+            *polygon.append() = pts[i];
+            i = next[i];
+        } while (i != first);
+        simplified->addPoly(polygon.begin(), polygon.count(), true);
+    }
+    return maxError;
+}
+
+bool GrTriangulator::FitPointBudget(const SkPath& path,
+                                    SkScalar tolerance,
+                                    int maxPoints,
+                                    SkScalar* budgetTolerance,
+                                    SkPath* simplified,
+                                    SkScalar* error) {
+    *budgetTolerance = tolerance;
+    *error = tolerance;
+    if (maxPoints <= 0 || !(tolerance > 0)) {
+        return false;
+    }
+    // Nothing to do if step (1) already fits. Its curves stop subdividing once they are flat
+    // enough, so it often yields far fewer points than flattening the path would.
+    int contourCnt = get_contour_count(path, tolerance);
+    if (contourCnt <= 0) {
+        return false;
+    }
+    {
+        SkArenaAlloc alloc(kArenaDefaultChunkSize);
+        GrTriangulator triangulator(path, &alloc);
+        // one more for the clip bounds of an inverse fill
+        std::unique_ptr<VertexList[]> contours(new VertexList[contourCnt + 1]);
+        bool isLinear;
+        triangulator.pathToContours(tolerance, SkRect::MakeEmpty(), contours.get(), &isLinear);
+        int64_t count = 0;
+        for (int i = 0; i <= contourCnt; ++i) {
+            for (Vertex* v = contours[i].fHead; v; v = v->fNext) {
+                ++count;
+            }
+        }
+        if (count <= maxPoints) {
+            return false;
+        }
+    }
+
+    // Otherwise the outline to triangulate is the path flattened into polylines, whose points
+    // flattened_point_count() counts exactly. Wang's formula gives each curve about
+    // 1/sqrt(tolerance) segments, so doubling the tolerance shaves off a good fraction of them.
+    // Double until the points fit or the curves are down to chords, then bisect back down so as
+    // to not overshoot by up to 2x. A tolerance that leaves more contours without area than the
+    // original one would drop them from the mesh, so it is too coarse however many points it has.
+    int64_t curvePoints;
+    int baseThinContours, thinContours;
+    int64_t count = flattened_point_count(path, tolerance, &curvePoints, &baseThinContours);
+    auto coarseEnough = [&](SkScalar tol) {
+        count = flattened_point_count(path, tol, &curvePoints, &thinContours);
+        return count <= maxPoints || curvePoints == 0 || thinContours > baseThinContours;
+    };
+    SkScalar lo = tolerance, hi = tolerance;
+    if (count > maxPoints && curvePoints > 0) {
+        do {
+            lo = hi;
+            hi *= 2;
+        } while (!coarseEnough(hi) && hi < PK_ScalarMax / 2);
+        for (int i = 0; i < 8; ++i) {
+            SkScalar mid = (lo + hi) / 2;
+            if (coarseEnough(mid)) {
+                hi = mid;
+            } else {
+                lo = mid;
+            }
+        }
+        coarseEnough(hi);
+        if (thinContours > baseThinContours) {
+            hi = lo;
+        }
+    }
+    *budgetTolerance = hi;
+    *error = hi;
+
+    class PolylineSink : public SkPath::FlattenSink {
+    public:
+        void polyline(const SkPoint pts[], int count, bool) override {
+            if (count > 1 && pts[count - 1] == pts[0]) {
+                --count;
+            }
+            if (count >= 3) {
+                fPoints.append(count, pts);
+                *fStarts.append() = fPoints.count();
+            }
+        }
+
+        SkTDArray<SkPoint> fPoints;
+        SkTDArray<int> fStarts{0};
+    };
+    PolylineSink sink;
+    path.flatten(hi, SkMatrix::I(), &sink);
+    simplified->reset();
+    simplified->setFillType(path.getFillType());
+    // If even the chords are too many, drop points from the polylines instead.
+    *error = hi + simplify_polylines(sink.fPoints, sink.fStarts, maxPoints, simplified);
+    return true;
+}
+
+int GrTriangulator::PathToTrianglesWithBudget(const SkPath& path,
+                                              SkScalar tolerance,
+                                              const SkRect& clipBounds,
+                                              int maxPoints,
+                                              std::vector<float>* vertex,
+                                              bool* isLinear,
+                                              SkScalar* error) {
+    SkScalar budgetTolerance;
+    SkPath simplified;
+    if (!FitPointBudget(path, tolerance, maxPoints, &budgetTolerance, &simplified, error)) {
+        return PathToTriangles(path, budgetTolerance, clipBounds, vertex, isLinear);
+    }
+    int count = PathToTriangles(simplified, budgetTolerance, clipBounds, vertex, isLinear);
+    *isLinear = !(path.getSegmentMasks() &
+                  (SkPath::kQuad_SegmentMask | SkPath::kConic_SegmentMask |
+                   SkPath::kCubic_SegmentMask));
+    return count;
 }
 }  // namespace pk
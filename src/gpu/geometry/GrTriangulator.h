@@ -12,6 +12,8 @@
 #include "include/core/SkPoint.h"
 #include "src/core/SkArenaAlloc.h"
 
+#include <functional>
+
 namespace pk {
 struct SkRect;
 
@@ -33,10 +35,73 @@ public:
         if (!path.isFinite()) {
             return 0;
         }
-        SkArenaAlloc alloc(kArenaDefaultChunkSize);
-        GrTriangulator triangulator(path, &alloc);
-        Poly* polys = triangulator.pathToPolys(tolerance, clipBounds, isLinear);
-        return triangulator.polysToTriangles(polys, vertex);
+        VertexWriter writer(vertex);
+        return PathToTriangles(path, tolerance, clipBounds, &writer, isLinear);
+    }
+
+    // Same as PathToTriangles, but writes the vertices straight into memory locked from allocator.
+    static int PathToTriangles(const SkPath& path,
+                               SkScalar tolerance,
+                               const SkRect& clipBounds,
+                               SkPath::VertexAllocator* allocator,
+                               bool* isLinear) {
+        VertexWriter writer(allocator);
+        return PathToTriangles(path, tolerance, clipBounds, &writer, isLinear);
+    }
+
+    // Same as PathToTriangles, but first splits the path into groups of contours whose bounds don't
+    // overlap, which therefore can't affect each other's winding. The groups are triangulated
+    // independently on up to maxThreads threads (0 uses one per hardware thread), and their
+    // vertices are concatenated in contour order. Even on one thread, several small meshes are
+    // cheaper to sort and simplify than one big one.
+    static int PathToTrianglesInParallel(const SkPath& path,
+                                         SkScalar tolerance,
+                                         const SkRect& clipBounds,
+                                         std::vector<float>* vertex,
+                                         bool* isLinear,
+                                         int maxThreads);
+
+    // Triangulates only the part of the path inside clipBounds, split into a row-major grid of
+    // tiles no bigger than tileWidth x tileHeight. The path is linearized once, each contour is
+    // clipped to the tiles its bounds touch, and the tiles are triangulated independently on up to
+    // maxThreads threads. tileOffsets receives the first vertex of each tile, followed by the
+    // total vertex count, so that tile i owns vertices [tileOffsets[i], tileOffsets[i + 1]).
+    // Returns 0 if the tile size would split clipBounds into more than kMaxTiles tiles.
+    constexpr static int kMaxTiles = 1 << 16;
+    static int PathToTiledTriangles(const SkPath& path,
+                                    SkScalar tolerance,
+                                    const SkRect& clipBounds,
+                                    SkScalar tileWidth,
+                                    SkScalar tileHeight,
+                                    std::vector<float>* vertex,
+                                    std::vector<int>* tileOffsets,
+                                    bool* isLinear,
+                                    int maxThreads);
+
+    // Same as PathToTriangles, but keeps the linearized path within maxPoints points so that
+    // pathological input can't blow up the mesh (see FitPointBudget). *error receives a bound on
+    // the distance between the triangulated outline and the path.
+    static int PathToTrianglesWithBudget(const SkPath& path,
+                                         SkScalar tolerance,
+                                         const SkRect& clipBounds,
+                                         int maxPoints,
+                                         std::vector<float>* vertex,
+                                         bool* isLinear,
+                                         SkScalar* error);
+
+    // Same as PathToTriangles, but writes each vertex of the mesh only once and describes the
+    // triangles with an index buffer. The mesh is appended to vertex and indices, and its indices
+    // count on from the vertices already in vertex. Returns the total number of indices, or 0 with
+    // both vectors left as they were if the vertices do not fit in IndexType.
+    template <typename IndexType>
+    static int PathToIndexedTriangles(const SkPath& path,
+                                      SkScalar tolerance,
+                                      const SkRect& clipBounds,
+                                      std::vector<float>* vertex,
+                                      std::vector<IndexType>* indices,
+                                      bool* isLinear) {
+        VertexWriter writer(vertex, indices);
+        return PathToTriangles(path, tolerance, clipBounds, &writer, isLinear);
     }
 
     // Enums used by GrTriangulator internals.
@@ -53,7 +118,54 @@ public:
     struct Poly;
     struct Comparator;
 
+    // Destination of stage 6. Without an index buffer, every triangle writes its three vertices
+    // through fData, which points into either fVertices or memory locked from fAllocator. With an
+    // index buffer, each mesh Vertex is appended to fVertices the first time a triangle uses it,
+    // and the triangles are written as indices into fVertices.
+    struct VertexWriter {
+        explicit VertexWriter(std::vector<float>* vertices) : fVertices(vertices) {}
+        explicit VertexWriter(SkPath::VertexAllocator* allocator) : fAllocator(allocator) {}
+        VertexWriter(std::vector<float>* vertices, std::vector<uint16_t>* indices)
+                : fVertices(vertices), fIndices16(indices) {}
+        VertexWriter(std::vector<float>* vertices, std::vector<uint32_t>* indices)
+                : fVertices(vertices), fIndices32(indices) {}
+
+        bool isIndexed() const { return fIndices16 || fIndices32; }
+        size_t indexCount() const {
+            return fIndices16 ? fIndices16->size() : fIndices32 ? fIndices32->size() : 0;
+        }
+
+        std::vector<float>* fVertices = nullptr;
+        SkPath::VertexAllocator* fAllocator = nullptr;
+        float* fData = nullptr;
+        float* fDataStart = nullptr;
+        std::vector<uint16_t>* fIndices16 = nullptr;
+        std::vector<uint32_t>* fIndices32 = nullptr;
+        int64_t fVertexCount = 0;       // index of the next vertex appended to fVertices
+        size_t fVerticesStart = 0;      // sizes on entry, restored if the indices overflow
+        size_t fIndicesStart = 0;
+    };
+
 protected:
+    static int PathToTriangles(const SkPath& path,
+                               SkScalar tolerance,
+                               const SkRect& clipBounds,
+                               VertexWriter* writer,
+                               bool* isLinear) {
+        if (!path.isFinite()) {
+            return 0;
+        }
+        SkArenaAlloc alloc(kArenaDefaultChunkSize);
+        GrTriangulator triangulator(path, &alloc);
+        int count;
+        if (IsSingleConvexContour(path) &&
+            triangulator.convexPathToTriangles(tolerance, clipBounds, writer, isLinear, &count)) {
+            return count;
+        }
+        Poly* polys = triangulator.pathToPolys(tolerance, clipBounds, isLinear);
+        return triangulator.polysToTriangles(polys, writer);
+    }
+
     GrTriangulator(const SkPath& path, SkArenaAlloc* alloc) : fPath(path), fAlloc(alloc) {}
     virtual ~GrTriangulator() {}
 
@@ -88,9 +200,58 @@ protected:
 
     // 6) Triangulate the monotone polygons directly into a vertex buffer:
     void polysToTriangles(Poly* polys,
-                          std::vector<float>* data,
+                          VertexWriter* writer,
                           SkPathFillType overrideFillType) const;
 
+    // Splits path into groups of contours such that the bounds of contours in different groups,
+    // outset by outset, don't overlap. Returns false if the path has fewer than two such groups or
+    // can't be split because it has an inverse fill type.
+    static bool SplitDisjointContours(const SkPath& path,
+                                      SkScalar outset,
+                                      std::vector<SkPath>* groups);
+    // Calls triangulate for every group on up to maxThreads threads, then appends their vertices
+    // to vertex in group order. If groupOffsets is not null, it receives the float offset at which
+    // each group starts, followed by the end offset. Returns true if all groups were linear.
+    using GroupTriangulator =
+            std::function<void(int group, std::vector<float>* vertex, bool* isLinear)>;
+    static bool TriangulateGroups(const std::vector<SkPath>& groups,
+                                  int maxThreads,
+                                  const GroupTriangulator& triangulate,
+                                  std::vector<float>* vertex,
+                                  std::vector<size_t>* groupOffsets = nullptr);
+
+    // Keeps the outline to triangulate within maxPoints points. Returns false if step (1) already
+    // linearizes path at tolerance within the budget. Otherwise path is flattened into polylines
+    // at a tolerance raised from tolerance, returned in *budgetTolerance, until they fit or its
+    // curves are down to chords. Polylines that still don't fit are simplified by repeatedly
+    // dropping the point whose removal moves the outline the least, keeping at least three points
+    // in each. The polylines are returned in *simplified together with true. *error receives a
+    // bound on the distance between the outline to triangulate and the path. A non-positive
+    // maxPoints means no budget.
+    static bool FitPointBudget(const SkPath& path,
+                               SkScalar tolerance,
+                               int maxPoints,
+                               SkScalar* budgetTolerance,
+                               SkPath* simplified,
+                               SkScalar* error);
+
+    // Convex fast path: a single convex contour needs none of steps (2)-(5). After (1) and the
+    // usual contour sanitizing, it is emitted directly as a fan around its first vertex. Returns
+    // false without writing anything if the linearized contour turns out not to be convex, in
+    // which case the general algorithm must run.
+    static bool IsSingleConvexContour(const SkPath&);
+    bool convexPathToTriangles(float tolerance,
+                               const SkRect& clipBounds,
+                               VertexWriter* writer,
+                               bool* isLinear,
+                               int* count) const;
+    // Runs step (1) for a single contour and sanitizes it. Returns the number of vertices left, or
+    // -1 if they don't all turn the same way.
+    int pathToConvexContour(float tolerance,
+                            const SkRect& clipBounds,
+                            VertexList* contour,
+                            bool* isLinear) const;
+
     // The vertex sorting in step (3) is a merge sort, since it plays well with the linked list
     // of vertices (and the necessity of inserting new vertices on intersection).
     //
@@ -135,10 +296,10 @@ protected:
     // setting rotates 90 degrees counterclockwise, rather that transposing.
 
     // Additional helpers and driver functions.
-    void emitMonotonePoly(const MonotonePoly*, std::vector<float>* data) const;
+    void emitMonotonePoly(const MonotonePoly*, VertexWriter* writer) const;
     void emitTriangle(
-            Vertex* prev, Vertex* curr, Vertex* next, int winding, std::vector<float>* data) const;
-    void emitPoly(const Poly*, std::vector<float>* data) const;
+            Vertex* prev, Vertex* curr, Vertex* next, int winding, VertexWriter* writer) const;
+    void emitPoly(const Poly*, VertexWriter* writer) const;
     Poly* makePoly(Poly** head, Vertex* v, int winding) const;
     void appendPointToContour(const SkPoint& p, VertexList* contour) const;
     void appendQuadraticToContour(const SkPoint[3],
@@ -212,7 +373,11 @@ protected:
     Poly* contoursToPolys(VertexList* contours, int contourCnt) const;
     Poly* pathToPolys(float tolerance, const SkRect& clipBounds, bool* isLinear) const;
     static int64_t CountPoints(Poly* polys, SkPathFillType overrideFillType);
-    int polysToTriangles(Poly*, std::vector<float>*) const;
+    int polysToTriangles(Poly*, VertexWriter*) const;
+    // Reserves room for count64 triangle vertices and returns false if they can't be addressed.
+    bool reserveTriangles(int64_t count64, VertexWriter*) const;
+    // Returns the number of vertices (or indices, if indexed) written, or 0 on overflow.
+    int finishTriangles(VertexWriter*) const;
 
     // FIXME: fPath should be plumbed through function parameters instead.
     const SkPath fPath;
@@ -315,6 +480,7 @@ struct GrTriangulator::Vertex {
             , fPartner(nullptr)
             , fAlpha(alpha)
             , fSynthetic(false)
+            , fIndex(-1)
 #if TRIANGULATOR_LOGGING
             , fID(-1.0f)
 #endif
@@ -332,6 +498,7 @@ struct GrTriangulator::Vertex {
     Vertex* fPartner;           // Corresponding inner or outer vertex (for AA).
     uint8_t fAlpha;
     bool fSynthetic;  // Is this a synthetic vertex?
+    int fIndex;       // Position in the indexed vertex buffer, or -1 if not yet written.
 #if TRIANGULATOR_LOGGING
     float fID;  // Identifier used for logging.
 #endif
@@ -421,12 +588,15 @@ struct GrTriangulator::Line {
 
 struct GrTriangulator::Edge {
     Edge(Vertex* top, Vertex* bottom, int winding, EdgeType type)
-            : fWinding(winding)
-            , fTop(top)
-            , fBottom(bottom)
-            , fType(type)
+            : fLine(top, bottom)
+            , fTopPoint(top->fPoint)
+            , fBottomPoint(bottom->fPoint)
             , fLeft(nullptr)
             , fRight(nullptr)
+            , fWinding(winding)
+            , fType(type)
+            , fTop(top)
+            , fBottom(bottom)
             , fPrevEdgeAbove(nullptr)
             , fNextEdgeAbove(nullptr)
             , fPrevEdgeBelow(nullptr)
@@ -438,14 +608,18 @@ struct GrTriangulator::Edge {
             , fRightPolyPrev(nullptr)
             , fRightPolyNext(nullptr)
             , fUsedInLeftPoly(false)
-            , fUsedInRightPoly(false)
-            , fLine(top, bottom) {}
-    int fWinding;     // 1 == edge goes downward; -1 = edge goes upward.
-    Vertex* fTop;     // The top vertex in vertex-sort-order (sweep_lt).
-    Vertex* fBottom;  // The bottom vertex in vertex-sort-order.
-    EdgeType fType;
+            , fUsedInRightPoly(false) {}
+    // The fields read while walking the active edge list come first and fit in one cache line,
+    // with copies of the endpoints so that dist() doesn't have to touch the vertices.
+    Line fLine;
+    SkPoint fTopPoint;     // fTop->fPoint, as of the last recompute().
+    SkPoint fBottomPoint;  // fBottom->fPoint, as of the last recompute().
     Edge* fLeft;           // The linked list of edges in the active edge list.
     Edge* fRight;          // "
+    int fWinding;          // 1 == edge goes downward; -1 = edge goes upward.
+    EdgeType fType;
+    Vertex* fTop;          // The top vertex in vertex-sort-order (sweep_lt).
+    Vertex* fBottom;       // The bottom vertex in vertex-sort-order.
     Edge* fPrevEdgeAbove;  // The linked list of edges in the bottom Vertex's "edges above".
     Edge* fNextEdgeAbove;  // "
     Edge* fPrevEdgeBelow;  // The linked list of edges in the top Vertex's "edges below".
@@ -458,17 +632,20 @@ struct GrTriangulator::Edge {
     Edge* fRightPolyNext;
     bool fUsedInLeftPoly;
     bool fUsedInRightPoly;
-    Line fLine;
 
     double dist(const SkPoint& p) const {
         // Coerce points coincident with the vertices to have dist = 0, since converting from
         // a double intersection point back to float storage might construct a point that's no
         // longer on the ideal line.
-        return (p == fTop->fPoint || p == fBottom->fPoint) ? 0.0 : fLine.dist(p);
+        return (p == fTopPoint || p == fBottomPoint) ? 0.0 : fLine.dist(p);
     }
     bool isRightOf(Vertex* v) const { return this->dist(v->fPoint) < 0.0; }
     bool isLeftOf(Vertex* v) const { return this->dist(v->fPoint) > 0.0; }
-    void recompute() { fLine = Line(fTop, fBottom); }
+    void recompute() {
+        fLine = Line(fTop, fBottom);
+        fTopPoint = fTop->fPoint;
+        fBottomPoint = fBottom->fPoint;
+    }
     void insertAbove(Vertex*, const Comparator&);
     void insertBelow(Vertex*, const Comparator&);
     void disconnect();
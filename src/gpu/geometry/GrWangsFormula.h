@@ -35,6 +35,26 @@ template <int Degree> constexpr float length_term_pow2(float precision) {
 PK_ALWAYS_INLINE static int nextlog16(float x) { return (pk_float_nextlog2(x) + 3) >> 2; }
 
 // Returns Wang's formula, raised to the 4th power, specialized for a quadratic curve.
+PK_ALWAYS_INLINE static float quadratic_pow4(float precision,
+                                             const SkPoint pts[],
+                                             const GrVectorXform& vectorXform = GrVectorXform()) {
+    using grvx::float2;
+    float2 p0 = float2::Load(pts);
+    float2 p1 = float2::Load(pts + 1);
+    float2 p2 = float2::Load(pts + 2);
+    float2 v = grvx::fast_madd<2>(-2, p1, p0) + p2;
+    v = vectorXform(v);
+    float2 vv = v * v;
+    return (vv[0] + vv[1]) * length_term_pow2<2>(precision);
+}
+
+// Returns Wang's formula specialized for a quadratic curve.
+PK_ALWAYS_INLINE static float quadratic(float precision,
+                                        const SkPoint pts[],
+                                        const GrVectorXform& vectorXform = GrVectorXform()) {
+    return sqrtf(sqrtf(quadratic_pow4(precision, pts, vectorXform)));
+}
+
 // Returns Wang's formula, raised to the 4th power, specialized for a cubic curve.
 PK_ALWAYS_INLINE static float cubic_pow4(float precision,
                                          const SkPoint pts[],
@@ -49,6 +69,13 @@ PK_ALWAYS_INLINE static float cubic_pow4(float precision,
     return std::max(vv[0] + vv[1], vv[2] + vv[3]) * length_term_pow2<3>(precision);
 }
 
+// Returns Wang's formula specialized for a cubic curve.
+PK_ALWAYS_INLINE static float cubic(float precision,
+                                    const SkPoint pts[],
+                                    const GrVectorXform& vectorXform = GrVectorXform()) {
+    return sqrtf(sqrtf(cubic_pow4(precision, pts, vectorXform)));
+}
+
 // Returns the log2 value of Wang's formula specialized for a cubic curve, rounded up to the next
 // int.
 PK_ALWAYS_INLINE static int cubic_log2(float precision,
@@ -57,6 +84,49 @@ PK_ALWAYS_INLINE static int cubic_log2(float precision,
     // nextlog16(x) == ceil(log2(sqrt(sqrt(x))))
     return nextlog16(cubic_pow4(precision, pts, vectorXform));
 }
+
+PK_ALWAYS_INLINE static float length_pow2(grvx::float2 v) {
+    v *= v;
+    return v[0] + v[1];
+}
+
+// Returns Wang's formula specialized for a conic curve, raised to the second power.
+//
+// This is not actually due to Wang, but is an analogue from (Theorem 3, corollary 1):
+//   J. Zheng, T. Sederberg. "Estimating Tessellation Parameter Intervals for
+//   Rational Curves and Surfaces." ACM Transactions on Graphics 19(1). 2000.
+PK_ALWAYS_INLINE static float conic_pow2(float precision,
+                                         const SkPoint pts[],
+                                         float w,
+                                         const GrVectorXform& vectorXform = GrVectorXform()) {
+    using grvx::float2;
+    float2 p0 = vectorXform(float2::Load(pts));
+    float2 p1 = vectorXform(float2::Load(pts + 1));
+    float2 p2 = vectorXform(float2::Load(pts + 2));
+    // Translate by the center of the bounding box. This improves translation-invariance of the
+    // formula, see Sec. 3.3 of the cited paper.
+    float2 c = 0.5f * (skvx::min(skvx::min(p0, p1), p2) + skvx::max(skvx::max(p0, p1), p2));
+    p0 -= c;
+    p1 -= c;
+    p2 -= c;
+    float maxLen = sqrtf(std::max(length_pow2(p0),
+                                  std::max(length_pow2(p1), length_pow2(p2))));
+    float2 dp = grvx::fast_madd<2>(-2 * w, p1, p0) + p2;
+    float dw = fabsf(2 - 2 * w);
+    // The epsilon referenced in the cited paper is 1/precision.
+    float rpMinus1 = std::max(0.f, maxLen * precision - 1);
+    float numer = sqrtf(length_pow2(dp)) * precision + rpMinus1 * dw;
+    float denom = 4 * std::min(w, 1.f);
+    return numer / denom;
+}
+
+// Returns Wang's formula specialized for a conic curve.
+PK_ALWAYS_INLINE static float conic(float precision,
+                                    const SkPoint pts[],
+                                    float w,
+                                    const GrVectorXform& vectorXform = GrVectorXform()) {
+    return sqrtf(conic_pow2(precision, pts, w, vectorXform));
+}
 }  // namespace GrWangsFormula
 }  // namespace pk
 
@@ -5,12 +5,16 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkContourMeasure.h"
 #include "include/core/SkPathMeasure.h"
 #include "include/core/SkStrokeRec.h"
+#include "src/core/SkPathMeasurePriv.h"
 #include "src/core/SkPathPriv.h"
 #include "src/core/SkPointPriv.h"
+#include "src/core/SkStroke.h"
 #include "src/utils/SkDashPathPriv.h"
 
+#include <memory>
 #include <utility>
 
 namespace pk {
@@ -203,41 +207,75 @@ static bool cull_path(const SkPath& srcPath, const SkStrokeRec& rec,
     return false;
 }
 
+// Dashes and strokes a single open polyline (e.g. a line) in one pass. Dashes that lie on one
+// line segment are emitted directly: butt and square caps as a quad (square caps just extend it
+// by the radius), round caps as a quad closed by two pairs of conic arcs. Dashes that turn a
+// corner need a join, so those are streamed into the stroker instead.
 class SpecialLineRec {
 public:
     bool init(const SkPath& src, SkPath* dst, SkStrokeRec* rec,
               int intervalCount, SkScalar intervalLength) {
-        if (rec->isHairlineStyle() || !src.isLine(fPts)) {
+        if (rec->isHairlineStyle() || src.getSegmentMasks() != SkPath::kLine_SegmentMask) {
             return false;
         }
-
-        // can relax this in the future, if we handle square and round caps
-        if (SkPaint::kButt_Cap != rec->getCap()) {
+        // The dashes are written straight to dst and never simplified, but they overlap around
+        // corners, and wherever their caps reach across a gap narrower than the stroke.
+        if (rec->getSimpleOutline()) {
             return false;
         }
 
-        SkScalar pathLength = SkPoint::Distance(fPts[0], fPts[1]);
+        // Accumulate the length the same way SkContourMeasure does, skipping zero-length lines.
+        SkScalar pathLength = 0;
+        for (auto [verb, pts, w] : SkPathPriv::Iterate(src)) {
+            switch (verb) {
+                case SkPathVerb::kMove:
+                    if (fPts.count() > 0) {
+                        return false;   // only a single contour
+                    }
+                    *fPts.append() = pts[0];
+                    *fDistances.append() = 0;
+                    break;
+                case SkPathVerb::kLine: {
+                    SkScalar segLength = SkPoint::Distance(pts[0], pts[1]);
+                    SkScalar prevLength = pathLength;
+                    pathLength += segLength;
+                    if (pathLength > prevLength) {
+                        SkVector* tangent = fTangents.append();
+                        *tangent = pts[1] - pts[0];
+                        tangent->scale(PkScalarInvert(segLength));
+                        *fPts.append() = pts[1];
+                        *fDistances.append() = pathLength;
+                    }
+                } break;
+                default:
+                    return false;   // only open contours
+            }
+        }
 
-        fTangent = fPts[1] - fPts[0];
-        if (fTangent.isZero()) {
+        if (fTangents.count() == 0 || !SkScalarIsFinite(pathLength)) {
             return false;
         }
 
         fPathLength = pathLength;
-        fTangent.scale(PkScalarInvert(pathLength));
-        SkPointPriv::RotateCCW(fTangent, &fNormal);
-        fNormal.scale(PkScalarHalf(rec->getWidth()));
+        fRadius = PkScalarHalf(rec->getWidth());
+        fCap = rec->getCap();
+        fSegIndex = 0;
+        fStroke.setCap(rec->getCap());
+        fStroke.setJoin(rec->getJoin());
+        fStroke.setMiterLimit(rec->getMiter());
+        fStroke.setWidth(rec->getWidth());
+        fStroke.setResScale(rec->getResScale());
 
         // now estimate how many quads will be added to the path
         //     resulting segments = pathLen * intervalCount / intervalLen
-        //     resulting points = 4 * segments
+        //     resulting points = 4 * segments (11 with round caps)
 
         SkScalar ptCount = pathLength * intervalCount / (float)intervalLength;
         ptCount = std::min(ptCount, SkDashPath::kMaxDashCount);
         if (SkScalarIsNaN(ptCount)) {
             return false;
         }
-        int n = PkScalarCeilToInt(ptCount) << 2;
+        int n = PkScalarCeilToInt(ptCount) * (SkPaint::kRound_Cap == fCap ? 11 : 4);
         dst->incReserve(n);
 
         // we will take care of the stroking
@@ -245,31 +283,99 @@ public:
         return true;
     }
 
-    void addSegment(SkScalar d0, SkScalar d1, SkPath* path) const {
+    // Dashes must be added in increasing order of distance.
+    void addSegment(SkScalar d0, SkScalar d1, SkPath* path) {
         // clamp the segment to our length
         if (d1 > fPathLength) {
             d1 = fPathLength;
         }
 
-        SkScalar x0 = fPts[0].fX + fTangent.fX * d0;
-        SkScalar x1 = fPts[0].fX + fTangent.fX * d1;
-        SkScalar y0 = fPts[0].fY + fTangent.fY * d0;
-        SkScalar y1 = fPts[0].fY + fTangent.fY * d1;
+        int lastSeg = fTangents.count() - 1;
+        while (fSegIndex < lastSeg && fDistances[fSegIndex + 1] <= d0) {
+            ++fSegIndex;
+        }
 
-        SkPoint pts[4];
-        pts[0].set(x0 + fNormal.fX, y0 + fNormal.fY);   // moveTo
-        pts[1].set(x1 + fNormal.fX, y1 + fNormal.fY);   // lineTo
-        pts[2].set(x1 - fNormal.fX, y1 - fNormal.fY);   // lineTo
-        pts[3].set(x0 - fNormal.fX, y0 - fNormal.fY);   // lineTo
+        if (d1 <= fDistances[fSegIndex + 1]) {
+            this->addCappedQuad(this->pointAt(fSegIndex, d0), this->pointAt(fSegIndex, d1),
+                                d0 == d1, fTangents[fSegIndex], path);
+            return;
+        }
+
+        if (!fCornerStroke) {
+            fCornerStroke = std::make_unique<SkStreamingStroke>(fStroke, 0);
+        }
+        fCornerStroke->moveTo(this->pointAt(fSegIndex, d0));
+        int seg = fSegIndex + 1;
+        while (seg < lastSeg && fDistances[seg + 1] < d1) {
+            fCornerStroke->lineTo(fPts[seg]);
+            ++seg;
+        }
+        fCornerStroke->lineTo(fPts[seg]);
+        fCornerStroke->lineTo(this->pointAt(seg, d1));
+    }
 
-        path->addPoly(pts, PK_ARRAY_COUNT(pts), false);
+    // Appends the dashes that were handed to the stroker.
+    void finish(SkPath* path) {
+        if (fCornerStroke) {
+            SkPath stroked;
+            fCornerStroke->done(&stroked);
+            path->addPath(stroked);
+        }
     }
 
 private:
-    SkPoint fPts[2];
-    SkVector fTangent;
-    SkVector fNormal;
-    SkScalar fPathLength;
+    SkPoint pointAt(int seg, SkScalar d) const {
+        SkScalar dt = d - fDistances[seg];
+        return SkPoint::Make(fPts[seg].fX + fTangents[seg].fX * dt,
+                             fPts[seg].fY + fTangents[seg].fY * dt);
+    }
+
+    void addCappedQuad(SkPoint p0, SkPoint p1, bool zeroLength, SkVector tangent,
+                       SkPath* path) const {
+        if (zeroLength && SkPaint::kButt_Cap != fCap) {
+            // Like the stroker, orient the caps of a zero-length dash upright.
+            tangent.set(0, PK_Scalar1);
+        }
+        SkVector normal;
+        SkPointPriv::RotateCCW(tangent, &normal);
+        normal.scale(fRadius);
+
+        SkVector parallel = tangent;
+        parallel.scale(fRadius);
+        if (SkPaint::kSquare_Cap == fCap) {
+            p0 -= parallel;
+            p1 += parallel;
+        }
+
+        SkPoint pts[4];
+        pts[0] = p0 + normal;   // moveTo
+        pts[1] = p1 + normal;   // lineTo
+        pts[2] = p1 - normal;   // lineTo
+        pts[3] = p0 - normal;   // lineTo
+
+        if (SkPaint::kRound_Cap != fCap) {
+            path->addPoly(pts, PK_ARRAY_COUNT(pts), false);
+            return;
+        }
+
+        path->moveTo(pts[0]);
+        path->lineTo(pts[1]);
+        path->conicTo(pts[1] + parallel, p1 + parallel, PK_ScalarRoot2Over2);
+        path->conicTo(pts[2] + parallel, pts[2], PK_ScalarRoot2Over2);
+        path->lineTo(pts[3]);
+        path->conicTo(pts[3] - parallel, p0 - parallel, PK_ScalarRoot2Over2);
+        path->conicTo(pts[0] - parallel, pts[0], PK_ScalarRoot2Over2);
+    }
+
+    SkTDArray<SkPoint>  fPts;
+    SkTDArray<SkScalar> fDistances;     // length of the polyline up to each point
+    SkTDArray<SkVector> fTangents;      // unit tangent of each line segment
+    SkScalar            fPathLength;
+    SkScalar            fRadius;
+    SkPaint::Cap        fCap;
+    int                 fSegIndex;      // segment holding the start of the last dash
+    SkStroke            fStroke;
+    std::unique_ptr<SkStreamingStroke> fCornerStroke;
 };
 
 
@@ -340,12 +446,57 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
     bool specialLine = (StrokeRecApplication::kAllow == strokeRecApplication) &&
                        lineRec.init(*srcPtr, dst, rec, count >> 1, intervalLength);
 
-    SkPathMeasure   meas(*srcPtr, false, rec->getResScale());
+    // Otherwise, if we are allowed to apply the stroke, feed the dashes straight to the stroker
+    // rather than materializing them as an intermediate path that would then be re-iterated.
+    std::unique_ptr<SkStreamingStroke> streamingStroke;
+    if (!specialLine && (StrokeRecApplication::kAllow == strokeRecApplication) &&
+        !rec->isHairlineStyle()) {
+        SkStroke stroke;
+        stroke.setCap(rec->getCap());
+        stroke.setJoin(rec->getJoin());
+        stroke.setMiterLimit(rec->getMiter());
+        stroke.setWidth(rec->getWidth());
+        stroke.setResScale(rec->getResScale());
+        stroke.setSimpleOutline(rec->getSimpleOutline());
+        streamingStroke = std::make_unique<SkStreamingStroke>(stroke, srcPtr->countPoints());
+    }
+
+    auto addSegment = [&](const SkContourMeasure& meas, SkScalar d0, SkScalar d1,
+                          bool startWithMoveTo) {
+        if (streamingStroke) {
+            return SkContourMeasurePriv::GetSegment(meas, d0, d1, streamingStroke.get(),
+                                                    startWithMoveTo);
+        }
+        return meas.getSegment(d0, d1, dst, startWithMoveTo);
+    };
+
+    // The "on" intervals of each contour are collected and extracted a chunk at a time, so the
+    // contour's segments are walked once rather than searched again for every dash.
+    // Zero-length dashes still add a zero-length line for the stroker to cap. The measure only
+    // rejects, adding nothing to dst, a dash that is NaN, that starts after it stops once clamped
+    // to the contour, or that maps to a non-finite t.
+    constexpr int kMaxPendingDashes = 256;
+    SkTDArray<SkScalar> pendingDashes;
+    bool droppedDash = false;
+    auto flushDashes = [&](const SkContourMeasure& meas) {
+        int pairs = pendingDashes.count() / 2;
+        bool addedAll;
+        if (streamingStroke) {
+            addedAll = SkContourMeasurePriv::GetSegments(meas, pendingDashes.begin(), pairs,
+                                                         streamingStroke.get());
+        } else {
+            addedAll = meas.getSegments(pendingDashes.begin(), pairs, dst);
+        }
+        droppedDash |= !addedAll;
+        pendingDashes.rewind();
+    };
+
+    SkContourMeasureIter iter(*srcPtr, false, rec->getResScale());
 
-    do {
-        bool        skipFirstSegment = meas.isClosed();
+    while (sk_sp<SkContourMeasure> meas = iter.next()) {
+        bool        skipFirstSegment = meas->isClosed();
         bool        addedSegment = false;
-        SkScalar    length = meas.getLength();
+        SkScalar    length = meas->length();
         int         index = initialDashIndex;
 
         // Since the path length / dash length ratio may be arbitrarily large, we can exert
@@ -378,9 +529,12 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
                             PkDoubleToScalar(distance), PkDoubleToScalar(distance + dlen),
                                        dst);
                 } else {
-                    meas.getSegment(PkDoubleToScalar(distance),
-                                    PkDoubleToScalar(distance + dlen),
-                                    dst, true);
+                    SkScalar* dash = pendingDashes.append(2);
+                    dash[0] = PkDoubleToScalar(distance);
+                    dash[1] = PkDoubleToScalar(distance + dlen);
+                    if (pendingDashes.count() == 2 * kMaxPendingDashes) {
+                        flushDashes(*meas);
+                    }
                 }
             }
             distance += dlen;
@@ -397,17 +551,36 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
             // fetch our next dlen
             dlen = intervals[index];
         }
+        flushDashes(*meas);
 
         // extend if we ended on a segment and we need to join up with the (skipped) initial segment
-        if (meas.isClosed() && is_even(initialDashIndex) &&
+        if (meas->isClosed() && is_even(initialDashIndex) &&
             initialDashLength >= 0) {
-            meas.getSegment(0, initialDashLength, dst, !addedSegment);
+            addSegment(*meas, 0, initialDashLength, !addedSegment);
             ++segCount;
         }
-    } while (meas.nextContour());
+    }
+
+    if (specialLine) {
+        lineRec.finish(dst);
+    }
+
+    if (streamingStroke) {
+        SkPath stroked;
+        streamingStroke->done(&stroked);
+        if (dst->isEmpty()) {
+            dst->swap(stroked);
+        } else {
+            dst->addPath(stroked);
+        }
+        // we took care of the stroking
+        rec->setFillStyle();
+    }
 
     // TODO: do we still need this?
-    if (segCount > 1) {
+    // segCount includes any dashes that were dropped, so it only proves several contours when
+    // none were.
+    if (segCount > 1 && !droppedDash) {
         SkPathPriv::SetConvexity(*dst, SkPathConvexity::kConcave);
     }
 
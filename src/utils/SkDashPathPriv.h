@@ -32,10 +32,11 @@ namespace SkDashPath {
     };
 
     /**
-     * Caller should have already used ValidDashPath to exclude invalid data. Typically, this leaves
-     * the strokeRec unmodified. However, for some simple shapes (e.g. a line) it may directly
-     * evaluate the dash and stroke to produce a stroked output path with a fill strokeRec. Passing
-     * true for disallowStrokeRecApplication turns this behavior off.
+     * Caller should have already used ValidDashPath to exclude invalid data. Hairline strokeRecs
+     * are left unmodified. For thick strokes the dashes are streamed directly into the stroker
+     * (or, for a single line, evaluated analytically), producing a stroked output path with a fill
+     * strokeRec. Passing StrokeRecApplication::kDisallow turns this behavior off, leaving the
+     * strokeRec unmodified and returning the dashed centerline.
      */
     bool InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
                         const SkRect* cullRect, const SkScalar aIntervals[],